@@ -0,0 +1,150 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <utility>
+#include <vector>
+
+// Bump allocator over large slabs.
+// Nothing is freed one by one: clear() and the destructor release all slabs
+// at once. One owner, no locks.
+class Arena {
+public:
+    explicit Arena(std::size_t slab_bytes = 64 * 1024)
+        : slab_bytes_(slab_bytes)
+    {}
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    ~Arena() {
+        release();
+    }
+
+    // Time - O(1) amortized
+    void* allocate(std::size_t bytes, std::size_t align) {
+        std::uintptr_t p = (reinterpret_cast<std::uintptr_t>(cursor_) + align - 1) & ~(align - 1);
+        if(cursor_ == nullptr || p + bytes > reinterpret_cast<std::uintptr_t>(end_)) {
+            grow(bytes + align);
+            p = (reinterpret_cast<std::uintptr_t>(cursor_) + align - 1) & ~(align - 1);
+        }
+        cursor_ = reinterpret_cast<char*>(p + bytes);
+        return reinterpret_cast<void*>(p);
+    }
+
+    // Keeps the first slab for reuse, frees the rest
+    // Time - O(slabs)
+    void clear() {
+        if(slabs_.empty()) {
+            return;
+        }
+        for(std::size_t i = 1; i < slabs_.size(); ++i) {
+            std::free(slabs_[i]);
+        }
+        slabs_.resize(1);
+        reserved_ = first_bytes_;
+        cursor_ = slabs_[0];
+        end_ = slabs_[0] + first_bytes_;
+    }
+
+    std::size_t bytes_reserved() const {
+        return reserved_;
+    }
+
+private:
+    void grow(std::size_t at_least) {
+        std::size_t bytes = std::max(slab_bytes_, at_least);
+        char* slab = static_cast<char*>(std::malloc(bytes));
+        if(slab == nullptr) {
+            throw std::bad_alloc();
+        }
+        if(slabs_.empty()) {
+            first_bytes_ = bytes;
+        }
+        slabs_.push_back(slab);
+        reserved_ += bytes;
+        cursor_ = slab;
+        end_ = slab + bytes;
+    }
+
+    void release() {
+        for(char* slab : slabs_) {
+            std::free(slab);
+        }
+        slabs_.clear();
+        cursor_ = nullptr;
+        end_ = nullptr;
+        reserved_ = 0;
+    }
+
+    std::vector<char*> slabs_;
+    char* cursor_{nullptr};
+    char* end_{nullptr};
+    std::size_t slab_bytes_;
+    std::size_t first_bytes_{0};
+    std::size_t reserved_{0};
+};
+
+// Fixed-size nodes carved out of an Arena, laid out back to back in
+// allocation order. recycle() puts a node on a free list for the next
+// create(). clear() drops every node at once without running destructors,
+// so owners of a non-trivial T destroy their live nodes first.
+template<typename T>
+class NodePool {
+public:
+    explicit NodePool(std::size_t slab_bytes = 64 * 1024)
+        : arena_(slab_bytes)
+    {}
+
+    // Time - O(1)
+    template<typename... Args>
+    T* create(Args&&... args) {
+        void* p;
+        if(free_ != nullptr) {
+            p = free_;
+            free_ = free_->next;
+        } else {
+            p = arena_.allocate(kSlot, kAlign);
+        }
+        ++live_;
+        return new (p) T{std::forward<Args>(args)...};
+    }
+
+    // Time - O(1)
+    void recycle(T* node) {
+        FreeSlot* slot = reinterpret_cast<FreeSlot*>(node);
+        slot->next = free_;
+        free_ = slot;
+        --live_;
+    }
+
+    // Time - O(slabs)
+    void clear() {
+        arena_.clear();
+        free_ = nullptr;
+        live_ = 0;
+    }
+
+    std::size_t live() const {
+        return live_;
+    }
+
+    std::size_t bytes_reserved() const {
+        return arena_.bytes_reserved();
+    }
+
+private:
+    struct FreeSlot {
+        FreeSlot* next;
+    };
+
+    static constexpr std::size_t kAlign = std::max(alignof(T), alignof(FreeSlot));
+    static constexpr std::size_t kSlot = (std::max(sizeof(T), sizeof(FreeSlot)) + kAlign - 1) / kAlign * kAlign;
+
+    Arena arena_;
+    FreeSlot* free_{nullptr};
+    std::size_t live_{0};
+};
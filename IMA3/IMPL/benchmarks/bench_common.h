@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+// Largest dataset of a sweep. The default keeps a full run within a few
+// minutes and a few GB; -DUFAR_BENCH_MAX=100000000 runs the 1e3..1e8 sweep.
+#ifndef UFAR_BENCH_MAX
+#define UFAR_BENCH_MAX 1000000
+#endif
+
+// Fixed seed, so two runs (or two commits) measure the same data
+constexpr std::uint64_t kBenchSeed = 20240601;
+
+// Dataset sizes 1e3, 1e4, ... up to UFAR_BENCH_MAX
+inline void Sizes(benchmark::internal::Benchmark* b) {
+    for(long long n = 1000; n <= UFAR_BENCH_MAX; n *= 10) {
+        b->Arg(n);
+    }
+    b->Unit(benchmark::kMillisecond);
+}
+
+// n random 63-bit keys. Salt 0 gives even keys and any other salt odd ones,
+// so a salted stream is a set of guaranteed misses
+inline const std::vector<std::int64_t>& RandomKeys(std::size_t n, std::uint64_t salt = 0) {
+    static std::map<std::pair<std::size_t, std::uint64_t>, std::vector<std::int64_t>> cache;
+    std::vector<std::int64_t>& keys = cache[{n, salt}];
+    if(keys.empty()) {
+        std::mt19937_64 rng(kBenchSeed ^ (salt * 0x9E3779B97F4A7C15ULL));
+        keys.resize(n);
+        for(std::int64_t& key : keys) {
+            key = static_cast<std::int64_t>((rng() >> 1) & ~1ULL) | (salt != 0 ? 1 : 0);
+        }
+    }
+    return keys;
+}
+
+// n lowercase words of 4..12 letters over a skewed alphabet, so prefixes share
+// paths the way natural-language queries do
+inline const std::vector<std::string>& RandomWords(std::size_t n, std::uint64_t salt = 0) {
+    static std::map<std::pair<std::size_t, std::uint64_t>, std::vector<std::string>> cache;
+    std::vector<std::string>& words = cache[{n, salt}];
+    if(words.empty()) {
+        std::mt19937_64 rng(kBenchSeed ^ (salt * 0x9E3779B97F4A7C15ULL));
+        std::geometric_distribution<int> letter(0.15);
+        words.resize(n);
+        for(std::string& word : words) {
+            int length = 4 + static_cast<int>(rng() % 9);
+            for(int i = 0; i < length; ++i) {
+                word += static_cast<char>('a' + letter(rng) % 26);
+            }
+        }
+    }
+    return words;
+}
@@ -0,0 +1,193 @@
+// Full traversals over the graph_2.cpp backends: the hash-map Graph, the CSR
+// graph with serial and direction-optimizing parallel BFS, relabelled CSR
+// graphs, and components.
+//
+//   g++ -std=c++17 -O2 -DNDEBUG -DUFAR_NO_MAIN -pthread bench_graph.cpp -lbenchmark -o bench_graph
+//   ./bench_graph --benchmark_out=graph.json --benchmark_out_format=json
+//
+// or through CMake (see CMakeLists.txt), which also runs the whole suite:
+//
+//   cmake --build build --target benchmarks_json
+//
+// The argument is the vertex count; every graph has 4 random undirected
+// edges per vertex, so it is one giant component plus a few stragglers.
+// Visitors are no-ops, so only the traversal is measured. The reordering
+// runs also use a square grid with shuffled vertex ids, a road-like graph
+// whose locality the relabelling can restore; random graphs have none.
+
+#include <cmath>
+#include <numeric>
+
+#include "bench_common.h"
+#include "../graph_2.cpp"
+
+constexpr int kEdgesPerVertex = 4;
+
+const SimpleGraph& RandomGraph(std::size_t n) {
+    static std::map<std::size_t, SimpleGraph> cache;
+    SimpleGraph& edges = cache[n];
+    if(edges.empty()) {
+        std::mt19937_64 rng(kBenchSeed);
+        edges.reserve(n * kEdgesPerVertex);
+        for(std::size_t i = 0; i < n * kEdgesPerVertex; ++i) {
+            edges.push_back(Edge{static_cast<VertexId>(rng() % n), static_cast<VertexId>(rng() % n)});
+        }
+    }
+    return edges;
+}
+
+// Grid of about n vertices, ids shuffled and edges in random order, so the
+// input labels have no locality left
+const SimpleGraph& ScrambledGrid(std::size_t n) {
+    static std::map<std::size_t, SimpleGraph> cache;
+    SimpleGraph& edges = cache[n];
+    if(edges.empty()) {
+        std::size_t side = static_cast<std::size_t>(std::sqrt(static_cast<double>(n)));
+        std::mt19937_64 rng(kBenchSeed);
+        std::vector<VertexId> id(side * side);
+        std::iota(id.begin(), id.end(), 0);
+        std::shuffle(id.begin(), id.end(), rng);
+        for(std::size_t r = 0; r < side; ++r) {
+            for(std::size_t c = 0; c < side; ++c) {
+                if(c + 1 < side) {
+                    edges.push_back(Edge{id[r * side + c], id[r * side + c + 1]});
+                }
+                if(r + 1 < side) {
+                    edges.push_back(Edge{id[r * side + c], id[(r + 1) * side + c]});
+                }
+            }
+        }
+        std::shuffle(edges.begin(), edges.end(), rng);
+    }
+    return edges;
+}
+
+using EdgeSource = const SimpleGraph& (*)(std::size_t);
+using VertexOrder = std::vector<int> (*)(const CsrGraph&);
+
+void BM_BuildGraph(benchmark::State& state) {
+    const SimpleGraph& edges = RandomGraph(state.range(0));
+    for(auto _ : state) {
+        Graph graph = CreateGraph(edges);
+        benchmark::DoNotOptimize(graph);
+    }
+    state.SetItemsProcessed(state.iterations() * edges.size());
+}
+
+void BM_BuildCsr(benchmark::State& state) {
+    const SimpleGraph& edges = RandomGraph(state.range(0));
+    for(auto _ : state) {
+        CsrGraph graph = CreateCsrGraph(edges);
+        benchmark::DoNotOptimize(graph);
+    }
+    state.SetItemsProcessed(state.iterations() * edges.size());
+}
+
+void BM_BuildCsrParallel(benchmark::State& state) {
+    const SimpleGraph& edges = RandomGraph(state.range(0));
+    for(auto _ : state) {
+        CsrGraph graph = CreateCsrGraphParallel(edges);
+        benchmark::DoNotOptimize(graph);
+    }
+    state.SetItemsProcessed(state.iterations() * edges.size());
+}
+
+void BM_Graph_Dfs(benchmark::State& state) {
+    Graph graph = CreateGraph(RandomGraph(state.range(0)));
+    for(auto _ : state) {
+        int reached = 0;
+        dfs_iterative(0, graph, [&](VertexId) { ++reached; });
+        benchmark::DoNotOptimize(reached);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_Graph_Bfs(benchmark::State& state) {
+    Graph graph = CreateGraph(RandomGraph(state.range(0)));
+    for(auto _ : state) {
+        benchmark::DoNotOptimize(bfs(0, -1, graph, [](VertexId) {}));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_Csr_Dfs(benchmark::State& state) {
+    CsrGraph graph = CreateCsrGraph(RandomGraph(state.range(0)));
+    DfsContext ctx;
+    for(auto _ : state) {
+        int reached = 0;
+        dfs_iterative(graph.dense(0), graph, ctx, [&](int) { ++reached; }, NullVisitor{});
+        benchmark::DoNotOptimize(reached);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_Csr_Bfs(benchmark::State& state) {
+    CsrGraph graph = CreateCsrGraph(RandomGraph(state.range(0)));
+    BfsContext ctx;
+    for(auto _ : state) {
+        benchmark::DoNotOptimize(bfs(graph.dense(0), -1, graph, ctx, NullVisitor{}, [](int, int) {}));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Same BFS after relabelling the vertices with one of the orders; a null
+// order keeps the input labels as the baseline. Starts from the vertex
+// with external id 0 so every order runs the same traversal.
+void BM_Csr_BfsReordered(benchmark::State& state, EdgeSource source, VertexOrder order) {
+    CsrGraph input = CreateCsrGraph(source(state.range(0)));
+    CsrGraph graph = order == nullptr ? input : ReorderCsrGraph(input, order(input));
+    BfsContext ctx;
+    for(auto _ : state) {
+        benchmark::DoNotOptimize(bfs(graph.dense(0), -1, graph, ctx, NullVisitor{}, [](int, int) {}));
+    }
+    state.SetItemsProcessed(state.iterations() * graph.vertex_count());
+}
+
+void BM_Reorder(benchmark::State& state, EdgeSource source, VertexOrder order) {
+    CsrGraph graph = CreateCsrGraph(source(state.range(0)));
+    for(auto _ : state) {
+        CsrGraph reordered = ReorderCsrGraph(graph, order(graph));
+        benchmark::DoNotOptimize(reordered);
+    }
+    state.SetItemsProcessed(state.iterations() * graph.vertex_count());
+}
+
+void BM_Csr_ParallelBfs(benchmark::State& state) {
+    CsrGraph graph = CreateCsrGraph(RandomGraph(state.range(0)));
+    for(auto _ : state) {
+        std::vector<int> levels = parallel_bfs(0, graph);
+        benchmark::DoNotOptimize(levels.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_Csr_Components(benchmark::State& state) {
+    CsrGraph graph = CreateCsrGraph(RandomGraph(state.range(0)));
+    for(auto _ : state) {
+        ComponentLabels components = connected_components(graph);
+        benchmark::DoNotOptimize(components.count);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_BuildGraph)->Apply(Sizes);
+BENCHMARK(BM_BuildCsr)->Apply(Sizes);
+BENCHMARK(BM_BuildCsrParallel)->Apply(Sizes)->UseRealTime();
+BENCHMARK_CAPTURE(BM_Reorder, random_rcm_order, RandomGraph, rcm_order)->Apply(Sizes);
+BENCHMARK_CAPTURE(BM_Reorder, grid_rcm_order, ScrambledGrid, rcm_order)->Apply(Sizes);
+
+BENCHMARK(BM_Graph_Dfs)->Apply(Sizes);
+BENCHMARK(BM_Graph_Bfs)->Apply(Sizes);
+BENCHMARK(BM_Csr_Dfs)->Apply(Sizes);
+BENCHMARK(BM_Csr_Bfs)->Apply(Sizes);
+BENCHMARK_CAPTURE(BM_Csr_BfsReordered, random_bfs_order, RandomGraph, bfs_order)->Apply(Sizes);
+BENCHMARK_CAPTURE(BM_Csr_BfsReordered, random_rcm_order, RandomGraph, rcm_order)->Apply(Sizes);
+BENCHMARK_CAPTURE(BM_Csr_BfsReordered, random_degree_order, RandomGraph, degree_order)->Apply(Sizes);
+BENCHMARK_CAPTURE(BM_Csr_BfsReordered, grid_input, ScrambledGrid, nullptr)->Apply(Sizes);
+BENCHMARK_CAPTURE(BM_Csr_BfsReordered, grid_bfs_order, ScrambledGrid, bfs_order)->Apply(Sizes);
+BENCHMARK_CAPTURE(BM_Csr_BfsReordered, grid_rcm_order, ScrambledGrid, rcm_order)->Apply(Sizes);
+BENCHMARK_CAPTURE(BM_Csr_BfsReordered, grid_degree_order, ScrambledGrid, degree_order)->Apply(Sizes);
+BENCHMARK(BM_Csr_ParallelBfs)->Apply(Sizes)->UseRealTime();
+BENCHMARK(BM_Csr_Components)->Apply(Sizes)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,156 @@
+// HashTable, FlatHashTable and SmallHashTable against std::unordered_set.
+//
+//   g++ -std=c++17 -O2 -DNDEBUG -DUFAR_NO_MAIN -pthread bench_hash_table.cpp -lbenchmark -o bench_hash_table
+//   ./bench_hash_table --benchmark_out=hash_table.json --benchmark_out_format=json
+//
+// or through CMake (see CMakeLists.txt), which also runs the whole suite:
+//
+//   cmake --build build --target benchmarks_json
+//
+// Keys are random 64-bit integers; find runs half hits, half misses.
+// SmallSet builds and queries many tiny sets, where allocation dominates.
+
+#include <unordered_set>
+
+#include "bench_common.h"
+#include "../hash_table.cpp"
+
+using Key = std::int64_t;
+
+// Every table starts this small and grows on its own
+constexpr int kInitialBuckets = 16;
+
+// find() answers bool on the repo tables and an iterator on std::unordered_set
+template<typename Set>
+bool Contains(Set& set, Key key) {
+    return set.find(key);
+}
+
+bool Contains(std::unordered_set<Key>& set, Key key) {
+    return set.count(key) != 0;
+}
+
+template<typename Set>
+void BM_Insert(benchmark::State& state) {
+    const std::vector<Key>& keys = RandomKeys(state.range(0));
+    for(auto _ : state) {
+        Set set(kInitialBuckets);
+        for(Key key : keys) {
+            set.insert(key);
+        }
+        benchmark::DoNotOptimize(set);
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+template<typename Set>
+void BM_Find(benchmark::State& state) {
+    const std::vector<Key>& keys = RandomKeys(state.range(0));
+    const std::vector<Key>& misses = RandomKeys(state.range(0), 1);
+    Set set(kInitialBuckets);
+    for(Key key : keys) {
+        set.insert(key);
+    }
+
+    std::vector<Key> queries;
+    queries.reserve(keys.size());
+    for(std::size_t i = 0; i < keys.size(); ++i) {
+        queries.push_back(i % 2 == 0 ? keys[keys.size() - 1 - i] : misses[i]);
+    }
+    for(auto _ : state) {
+        std::size_t found = 0;
+        for(Key key : queries) {
+            found += Contains(set, key);
+        }
+        benchmark::DoNotOptimize(found);
+    }
+    state.SetItemsProcessed(state.iterations() * queries.size());
+}
+
+// Batched lookups that prefetch a group of buckets before probing them
+template<typename Set>
+void BM_FindBatch(benchmark::State& state) {
+    const std::vector<Key>& keys = RandomKeys(state.range(0));
+    const std::vector<Key>& misses = RandomKeys(state.range(0), 1);
+    Set set(kInitialBuckets);
+    set.insert_batch(keys.data(), keys.size());
+
+    std::vector<Key> queries;
+    queries.reserve(keys.size());
+    for(std::size_t i = 0; i < keys.size(); ++i) {
+        queries.push_back(i % 2 == 0 ? keys[keys.size() - 1 - i] : misses[i]);
+    }
+    std::unique_ptr<bool[]> found(new bool[queries.size()]);
+    for(auto _ : state) {
+        set.find_batch(queries.data(), queries.size(), found.get());
+        benchmark::DoNotOptimize(found.get());
+    }
+    state.SetItemsProcessed(state.iterations() * queries.size());
+}
+
+// Rebuilding the table is excluded from the timing
+template<typename Set>
+void BM_Erase(benchmark::State& state) {
+    const std::vector<Key>& keys = RandomKeys(state.range(0));
+    for(auto _ : state) {
+        state.PauseTiming();
+        Set set(kInitialBuckets);
+        for(Key key : keys) {
+            set.insert(key);
+        }
+        state.ResumeTiming();
+        for(Key key : keys) {
+            set.erase(key);
+        }
+        benchmark::DoNotOptimize(set);
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+// n-key sets built, probed n times and dropped, as by a per-request scratch
+// set; pays every allocation a small set makes
+template<typename Set>
+void BM_SmallSet(benchmark::State& state) {
+    const std::vector<Key>& keys = RandomKeys(1 << 16);
+    const std::size_t n = state.range(0);
+    std::size_t first = 0;
+    for(auto _ : state) {
+        Set set;
+        for(std::size_t i = 0; i < n; ++i) {
+            set.insert(keys[first + i]);
+        }
+        std::size_t found = 0;
+        for(std::size_t i = 0; i < n; ++i) {
+            found += Contains(set, keys[first + (i * 5) % n]);
+        }
+        benchmark::DoNotOptimize(found);
+        first = (first + n) % (keys.size() - n);
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+void SmallSizes(benchmark::internal::Benchmark* b) {
+    for(int n : {2, 4, 8, 16}) {
+        b->Arg(n);
+    }
+}
+
+BENCHMARK_TEMPLATE(BM_Insert, std::unordered_set<Key>)->Apply(Sizes);
+BENCHMARK_TEMPLATE(BM_Insert, HashTable<Key>)->Apply(Sizes);
+BENCHMARK_TEMPLATE(BM_Insert, FlatHashTable<Key>)->Apply(Sizes);
+
+BENCHMARK_TEMPLATE(BM_Find, std::unordered_set<Key>)->Apply(Sizes);
+BENCHMARK_TEMPLATE(BM_Find, HashTable<Key>)->Apply(Sizes);
+BENCHMARK_TEMPLATE(BM_Find, FlatHashTable<Key>)->Apply(Sizes);
+BENCHMARK_TEMPLATE(BM_FindBatch, HashTable<Key>)->Apply(Sizes);
+BENCHMARK_TEMPLATE(BM_FindBatch, FlatHashTable<Key>)->Apply(Sizes);
+
+BENCHMARK_TEMPLATE(BM_Erase, std::unordered_set<Key>)->Apply(Sizes);
+BENCHMARK_TEMPLATE(BM_Erase, HashTable<Key>)->Apply(Sizes);
+BENCHMARK_TEMPLATE(BM_Erase, FlatHashTable<Key>)->Apply(Sizes);
+
+BENCHMARK_TEMPLATE(BM_SmallSet, std::unordered_set<Key>)->Apply(SmallSizes);
+BENCHMARK_TEMPLATE(BM_SmallSet, FlatHashTable<Key>)->Apply(SmallSizes);
+BENCHMARK_TEMPLATE(BM_SmallSet, SmallHashTable<Key>)->Apply(SmallSizes);
+
+BENCHMARK_MAIN();
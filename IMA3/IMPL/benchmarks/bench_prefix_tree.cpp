@@ -0,0 +1,241 @@
+// PrefixTree and its frozen snapshot against binary search over a sorted
+// std::vector<std::string>.
+//
+//   g++ -std=c++17 -O2 -DNDEBUG -DUFAR_NO_MAIN bench_prefix_tree.cpp -lbenchmark -pthread -o bench_prefix_tree
+//   ./bench_prefix_tree --benchmark_out=prefix_tree.json --benchmark_out_format=json
+//
+// or through CMake (see CMakeLists.txt), which also runs the whole suite:
+//
+//   cmake --build build --target benchmarks_json
+//
+// find runs half hits, half (mostly) misses. prefix_find asks for the top 5
+// completions of 3-letter prefixes of stored words; the sorted vector answers
+// with the first 5 in lexicographic order, which is cheaper than ranking.
+// The Digits runs store 10-digit phone numbers in the byte-alphabet tree
+// and in PrefixTree<Alphabet::Digits>, which has one direct slot per digit.
+
+#include <algorithm>
+
+#include "bench_common.h"
+#include "../prefix_tree.cpp"
+
+constexpr int kCompletions = 5;
+
+std::vector<std::string> SortedUnique(const std::vector<std::string>& words) {
+    std::vector<std::string> sorted = words;
+    std::sort(sorted.begin(), sorted.end());
+    sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+    return sorted;
+}
+
+std::vector<std::string> FindQueries(std::size_t n) {
+    const std::vector<std::string>& words = RandomWords(n);
+    const std::vector<std::string>& misses = RandomWords(n, 1);
+    std::vector<std::string> queries;
+    queries.reserve(n);
+    for(std::size_t i = 0; i < n; ++i) {
+        queries.push_back(i % 2 == 0 ? words[n - 1 - i] : misses[i]);
+    }
+    return queries;
+}
+
+std::vector<std::string> PrefixQueries(std::size_t n) {
+    const std::vector<std::string>& words = RandomWords(n);
+    std::vector<std::string> queries;
+    queries.reserve(n);
+    for(std::size_t i = 0; i < n; ++i) {
+        queries.push_back(words[(i * 7919) % n].substr(0, 3));
+    }
+    return queries;
+}
+
+void BM_PrefixTree_Insert(benchmark::State& state) {
+    const std::vector<std::string>& words = RandomWords(state.range(0));
+    for(auto _ : state) {
+        PrefixTree tree;
+        for(const std::string& word : words) {
+            tree.insert(word);
+        }
+        benchmark::DoNotOptimize(tree);
+    }
+    state.SetItemsProcessed(state.iterations() * words.size());
+}
+
+void BM_PrefixTree_BuildSorted(benchmark::State& state) {
+    std::vector<std::string> sorted = RandomWords(state.range(0));
+    std::sort(sorted.begin(), sorted.end());
+    PrefixTree tree;
+    for(auto _ : state) {
+        tree.build_from_sorted(sorted);
+        benchmark::DoNotOptimize(tree);
+    }
+    state.SetItemsProcessed(state.iterations() * sorted.size());
+}
+
+void BM_SortedVector_Build(benchmark::State& state) {
+    const std::vector<std::string>& words = RandomWords(state.range(0));
+    for(auto _ : state) {
+        std::vector<std::string> sorted = SortedUnique(words);
+        benchmark::DoNotOptimize(sorted.data());
+    }
+    state.SetItemsProcessed(state.iterations() * words.size());
+}
+
+void BM_PrefixTree_Find(benchmark::State& state) {
+    PrefixTree tree;
+    for(const std::string& word : RandomWords(state.range(0))) {
+        tree.insert(word);
+    }
+    std::vector<std::string> queries = FindQueries(state.range(0));
+    for(auto _ : state) {
+        std::size_t found = 0;
+        for(const std::string& query : queries) {
+            found += tree.find(query);
+        }
+        benchmark::DoNotOptimize(found);
+    }
+    state.SetItemsProcessed(state.iterations() * queries.size());
+}
+
+// Queried straight from the mapped file
+void BM_Snapshot_Find(benchmark::State& state) {
+    const std::string path = "bench_prefix_tree.snapshot";
+    {
+        PrefixTree tree;
+        for(const std::string& word : RandomWords(state.range(0))) {
+            tree.insert(word);
+        }
+        if(!tree.freeze(path)) {
+            state.SkipWithError("freeze failed");
+            return;
+        }
+    }
+    PrefixTreeSnapshot snapshot;
+    if(!snapshot.open(path)) {
+        state.SkipWithError("open failed");
+        return;
+    }
+    std::vector<std::string> queries = FindQueries(state.range(0));
+    for(auto _ : state) {
+        std::size_t found = 0;
+        for(const std::string& query : queries) {
+            found += snapshot.find(query);
+        }
+        benchmark::DoNotOptimize(found);
+    }
+    state.SetItemsProcessed(state.iterations() * queries.size());
+    snapshot.close();
+    std::remove(path.c_str());
+}
+
+void BM_SortedVector_Find(benchmark::State& state) {
+    std::vector<std::string> sorted = SortedUnique(RandomWords(state.range(0)));
+    std::vector<std::string> queries = FindQueries(state.range(0));
+    for(auto _ : state) {
+        std::size_t found = 0;
+        for(const std::string& query : queries) {
+            found += std::binary_search(sorted.begin(), sorted.end(), query);
+        }
+        benchmark::DoNotOptimize(found);
+    }
+    state.SetItemsProcessed(state.iterations() * queries.size());
+}
+
+void BM_PrefixTree_PrefixFind(benchmark::State& state) {
+    PrefixTree tree;
+    for(const std::string& word : RandomWords(state.range(0))) {
+        tree.insert(word);
+    }
+    std::vector<std::string> queries = PrefixQueries(state.range(0));
+    for(auto _ : state) {
+        std::size_t returned = 0;
+        for(const std::string& query : queries) {
+            returned += tree.prefix_find(query, kCompletions).size();
+        }
+        benchmark::DoNotOptimize(returned);
+    }
+    state.SetItemsProcessed(state.iterations() * queries.size());
+}
+
+void BM_SortedVector_PrefixFind(benchmark::State& state) {
+    std::vector<std::string> sorted = SortedUnique(RandomWords(state.range(0)));
+    std::vector<std::string> queries = PrefixQueries(state.range(0));
+    for(auto _ : state) {
+        std::size_t returned = 0;
+        for(const std::string& query : queries) {
+            std::vector<std::string> ans;
+            auto it = std::lower_bound(sorted.begin(), sorted.end(), query);
+            while (it != sorted.end() && static_cast<int>(ans.size()) < kCompletions &&
+                   it->compare(0, query.size(), query) == 0)
+            {
+                ans.push_back(*it++);
+            }
+            returned += ans.size();
+        }
+        benchmark::DoNotOptimize(returned);
+    }
+    state.SetItemsProcessed(state.iterations() * queries.size());
+}
+
+// n numbers of 10 digits under 100 shared 3-digit area codes
+const std::vector<std::string>& PhoneNumbers(std::size_t n, std::uint64_t salt = 0) {
+    static std::map<std::pair<std::size_t, std::uint64_t>, std::vector<std::string>> cache;
+    std::vector<std::string>& numbers = cache[{n, salt}];
+    if(numbers.empty()) {
+        std::mt19937_64 rng(kBenchSeed ^ (salt * 0x9E3779B97F4A7C15ULL));
+        numbers.resize(n);
+        for(std::string& number : numbers) {
+            number = std::to_string(100 + rng() % 100) + std::to_string(1000000 + rng() % 9000000);
+        }
+    }
+    return numbers;
+}
+
+template<typename Tree>
+void BM_Digits_Insert(benchmark::State& state) {
+    const std::vector<std::string>& numbers = PhoneNumbers(state.range(0));
+    for(auto _ : state) {
+        Tree tree;
+        for(const std::string& number : numbers) {
+            tree.insert(number);
+        }
+        benchmark::DoNotOptimize(tree);
+    }
+    state.SetItemsProcessed(state.iterations() * numbers.size());
+}
+
+template<typename Tree>
+void BM_Digits_Find(benchmark::State& state) {
+    const std::vector<std::string>& numbers = PhoneNumbers(state.range(0));
+    const std::vector<std::string>& misses = PhoneNumbers(state.range(0), 1);
+    Tree tree;
+    for(const std::string& number : numbers) {
+        tree.insert(number);
+    }
+    std::size_t found = 0;
+    for(auto _ : state) {
+        for(std::size_t i = 0; i < numbers.size(); ++i) {
+            found += tree.find(i % 2 == 0 ? numbers[numbers.size() - 1 - i] : misses[i]);
+        }
+        benchmark::DoNotOptimize(found);
+    }
+    state.SetItemsProcessed(state.iterations() * numbers.size());
+}
+
+BENCHMARK(BM_PrefixTree_Insert)->Apply(Sizes);
+BENCHMARK(BM_PrefixTree_BuildSorted)->Apply(Sizes);
+BENCHMARK(BM_SortedVector_Build)->Apply(Sizes);
+
+BENCHMARK(BM_PrefixTree_Find)->Apply(Sizes);
+BENCHMARK(BM_Snapshot_Find)->Apply(Sizes);
+BENCHMARK(BM_SortedVector_Find)->Apply(Sizes);
+
+BENCHMARK(BM_PrefixTree_PrefixFind)->Apply(Sizes);
+BENCHMARK(BM_SortedVector_PrefixFind)->Apply(Sizes);
+
+BENCHMARK_TEMPLATE(BM_Digits_Insert, PrefixTree<>)->Apply(Sizes);
+BENCHMARK_TEMPLATE(BM_Digits_Insert, PrefixTree<Alphabet::Digits>)->Apply(Sizes);
+BENCHMARK_TEMPLATE(BM_Digits_Find, PrefixTree<>)->Apply(Sizes);
+BENCHMARK_TEMPLATE(BM_Digits_Find, PrefixTree<Alphabet::Digits>)->Apply(Sizes);
+
+BENCHMARK_MAIN();
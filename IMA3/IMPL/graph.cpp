@@ -1,4 +1,6 @@
+#include <algorithm>
 #include <iostream>
+#include <queue>
 #include <vector>
 #include <unordered_map>
 #include <unordered_set>
@@ -29,9 +31,68 @@ void dfs(TreeNode* root) {
 template<typename T>
 using Set = std::unordered_set<T>;
 
+// Compressed sparse row adjacency over dense indices 0 .. N-1, so any int id
+// works, negative or sparse. ids[v] is the vertex id of index v.
+// Neighbors of v are neighbors[offsets[v]] .. neighbors[offsets[v + 1] - 1].
+struct CsrGraph {
+    int vertex_count() const {
+        return static_cast<int>(ids.size());
+    }
+
+    // Dense index of id, -1 if id is not a vertex
+    int find(int id) const {
+        auto it = index.find(id);
+        return it == index.end() ? -1 : it->second;
+    }
+
+    std::vector<int> offsets;
+    std::vector<int> neighbors;
+    std::vector<int> ids;
+    std::unordered_map<int, int> index;
+};
+
+// Interns the endpoints to dense indices, then two passes: count degrees,
+// then scatter.
+// Time - O(N + E)
+// Memory - O(N + E)
+CsrGraph build_csr(const std::vector<Edge>& edges) {
+    CsrGraph graph;
+    auto intern = [&](int id) {
+        auto inserted = graph.index.emplace(id, graph.vertex_count());
+        if(inserted.second) {
+            graph.ids.push_back(id);
+        }
+        return inserted.first->second;
+    };
+    std::vector<int> ends;
+    ends.reserve(edges.size() * 2);
+    for(const Edge& edge : edges) {
+        ends.push_back(intern(edge.a));
+        ends.push_back(intern(edge.b));
+    }
+
+    int n = graph.vertex_count();
+    graph.offsets.assign(n + 1, 0);
+    for(int v : ends) {
+        ++graph.offsets[v + 1];
+    }
+    for(int v = 0; v < n; ++v) {
+        graph.offsets[v + 1] += graph.offsets[v];
+    }
+
+    graph.neighbors.resize(graph.offsets.back());
+    std::vector<int> cursor(graph.offsets.begin(), graph.offsets.end() - 1);
+    for(std::size_t i = 0; i < ends.size(); i += 2) {
+        graph.neighbors[cursor[ends[i]]++] = ends[i + 1];
+        graph.neighbors[cursor[ends[i + 1]]++] = ends[i];
+    }
+    return graph;
+}
+
 // Time - O(N + E)
 // Memory - O(N)
-void dfs_graph(int node, std::unordered_map<int, Set<int>>& graph, Set<int>& visited) {
+template<typename Visitor>
+void dfs_graph(int node, std::unordered_map<int, Set<int>>& graph, Set<int>& visited, Visitor& visit) {
     if(visited.find(node) != visited.end()) {
         return;
     }
@@ -40,65 +101,115 @@ void dfs_graph(int node, std::unordered_map<int, Set<int>>& graph, Set<int>& vis
 
     const auto& next = graph[node];
     
-    std::cout << node << std::endl;
+    visit(node);
 
     for(int n : next) {
-        dfs_graph(n, graph, visited);
+        dfs_graph(n, graph, visited, visit);
+    }
+}
+
+// Explicit stack of (node, neighbor cursor) frames instead of recursion,
+// so path depth is not limited by the call stack. node is a dense index;
+// visit gets vertex ids.
+// Time - O(N + E)
+// Memory - O(N)
+template<typename Visitor>
+void dfs_graph(int node, const CsrGraph& graph, std::vector<bool>& visited, Visitor& visit) {
+    struct Frame {
+        int node;
+        int cursor;
+    };
+
+    if(visited[node]) {
+        return;
+    }
+
+    visited[node] = true;
+    visit(graph.ids[node]);
+
+    std::vector<Frame> stack{Frame{node, graph.offsets[node]}};
+    while (!stack.empty())
+    {
+        Frame& top = stack.back();
+        if(top.cursor == graph.offsets[top.node + 1]) {
+            stack.pop_back();
+            continue;
+        }
+
+        int n = graph.neighbors[top.cursor++];
+        if(visited[n]) {
+            continue;
+        }
+
+        visited[n] = true;
+        visit(graph.ids[n]);
+        stack.push_back(Frame{n, graph.offsets[n]});
     }
 }
 
 // O(N + E)
 // O(N + E)
-void dfs(int start_node, const std::vector<Edge>& edges) {
-    std::unordered_map<int, std::unordered_set<int>> graph;
-    
-    // Time - O(E)
+template<typename Visitor>
+void dfs(int start_node, const std::vector<Edge>& edges, Visitor&& visit) {
+    // Time - O(N + E)
     // Memory - O(N + E)
-    for(const Edge& edge : edges) {
-        graph[edge.a].insert(edge.b);
-        graph[edge.b].insert(edge.a);
+    CsrGraph graph = build_csr(edges);
+    int start = graph.find(start_node);
+    if(start < 0) {
+        return;
     }
 
     // Time - O(N + E)
     // Memory - O(N)
-    Set<int> visited;
-    dfs_graph(start_node, graph, visited);
+    std::vector<bool> visited(graph.vertex_count(), false);
+    dfs_graph(start, graph, visited, visit);
 }
 
-void bfs(int start_node, const std::vector<Edge>& edges) {
-    std::unordered_map<int, std::unordered_set<int>> graph;
-    
-    // Time - O(E)
+// '\n' instead of std::endl: the stream flushes in blocks, not per vertex
+void dfs(int start_node, const std::vector<Edge>& edges) {
+    dfs(start_node, edges, [](int n) { std::cout << n << '\n'; });
+}
+
+template<typename Visitor>
+void bfs(int start_node, const std::vector<Edge>& edges, Visitor&& visit) {
+    // Time - O(N + E)
     // Memory - O(N + E)
-    for(const Edge& edge : edges) {
-        graph[edge.a].insert(edge.b);
-        graph[edge.b].insert(edge.a);
+    CsrGraph graph = build_csr(edges);
+    int start = graph.find(start_node);
+    if(start < 0) {
+        return;
     }
 
-    Set<int> visited;
+    std::vector<bool> visited(graph.vertex_count(), false);
 
+    // Marked when pushed, so the queue holds at most N vertices
     std::queue<int> q;
-    q.push(start_node);
+    q.push(start);
+    visited[start] = true;
 
     while (!q.empty())
     {
         int curr = q.front();
         q.pop();
 
-        if(visited.find(curr) != visited.end()){
-            continue;
-        }
-
-        std::cout << curr << std::endl;
-        visited.insert(curr);
+        visit(graph.ids[curr]);
 
-        const auto& next = graph[curr];
-        for(int n : next) {
-            q.push(n);
+        for(int i = graph.offsets[curr]; i < graph.offsets[curr + 1]; ++i) {
+            int n = graph.neighbors[i];
+            if(!visited[n]) {
+                visited[n] = true;
+                q.push(n);
+            }
         }
     }
 }
 
+void bfs(int start_node, const std::vector<Edge>& edges) {
+    bfs(start_node, edges, [](int n) { std::cout << n << '\n'; });
+}
+
+// Define UFAR_NO_MAIN to include this file from a benchmark or another driver
+#ifndef UFAR_NO_MAIN
 int main() {
     std::vector<Edge> edges {
         Edge{1, 2},
@@ -110,11 +221,17 @@ int main() {
         Edge{4, 5}
     };
 
-    dfs(1, edges); // TODO : iterative
+    dfs(1, edges);
 
     std::cout << "-----------------" << std::endl;
 
     bfs(1, edges);
 
+    std::cout << "-----------------" << std::endl;
+
+    // Ids are interned, so negative and sparse ids cost no extra memory
+    bfs(-7, {Edge{-7, 1000000000}, Edge{1000000000, 42}, Edge{}});
+
     return 0;
 }
+#endif
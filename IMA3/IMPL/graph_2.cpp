@@ -1,8 +1,26 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
+#include "mapped_file.h"
+#include "stats.h"
+
 struct TreeNode {
     int data;
     TreeNode* left;
@@ -20,16 +38,26 @@ void dfs(TreeNode* root) {
     dfs(root->right);
 }
 
+using VertexId = std::int64_t;
+
 struct Edge {
-    int a;
-    int b;
+    VertexId a;
+    VertexId b;
 };
 
 using SimpleGraph = std::vector<Edge>;
 
-using Graph = std::unordered_map<int, std::unordered_set<int>>;
+using Graph = std::unordered_map<VertexId, std::unordered_set<VertexId>>;
 
-using VisitedSet = std::unordered_set<int>;
+using VisitedSet = std::unordered_set<VertexId>;
+
+// Read-only neighbour lookup, so queries can share one Graph without
+// operator[] inserting into it
+const std::unordered_set<VertexId>& Neighbors(const Graph& graph, VertexId node) {
+    static const std::unordered_set<VertexId> kNone;
+    auto it = graph.find(node);
+    return it != graph.end() ? it->second : kNone;
+}
 
 Graph CreateGraph(const SimpleGraph& graph) {
     Graph ans;
@@ -40,80 +68,2871 @@ Graph CreateGraph(const SimpleGraph& graph) {
     return ans;
 }
 
+// Maps sparse external ids to dense indices [0, N) in first-seen order.
+// Only used while building and at the API boundary, never inside a traversal.
+class IdInterner {
+public:
+    // Time - O(1), O(log N) while sorted ids are adopted
+    int intern(VertexId id) {
+        if(sorted_ > 0) {
+            int v = find_sorted(id);
+            if(v >= 0) {
+                return v;
+            }
+        }
+        if((index_size_ + 1) * 2 > slots_.size()) {
+            grow();
+        }
+        std::size_t i = home(id);
+        while (slots_[i].v >= 0 && slots_[i].id != id)
+        {
+            i = (i + 1) & (slots_.size() - 1);
+        }
+        if(slots_[i].v < 0) {
+            slots_[i] = Slot{id, static_cast<int>(ids_.size())};
+            ids_.push_back(id);
+            ++index_size_;
+        }
+        return slots_[i].v;
+    }
+
+    // Returns -1 for an unknown id
+    int find(VertexId id) const {
+        if(sorted_ > 0) {
+            int v = find_sorted(id);
+            if(v >= 0) {
+                return v;
+            }
+        }
+        if(slots_.empty()) {
+            return -1;
+        }
+        std::size_t i = home(id);
+        while (slots_[i].v >= 0)
+        {
+            if(slots_[i].id == id) {
+                return slots_[i].v;
+            }
+            i = (i + 1) & (slots_.size() - 1);
+        }
+        return -1;
+    }
+
+    // Takes sorted, unique ids as 0..N-1 in one move. They are found by
+    // binary search, so nothing is hashed; later ids go to the map.
+    // Time - O(1)
+    void assign_sorted(std::vector<VertexId> ids) {
+        slots_.clear();
+        index_size_ = 0;
+        ids_ = std::move(ids);
+        sorted_ = ids_.size();
+    }
+
+    VertexId external(int v) const {
+        return ids_[v];
+    }
+
+    int size() const {
+        return static_cast<int>(ids_.size());
+    }
+
+private:
+    // Open addressing with linear probing; v < 0 marks a free slot.
+    // The id sits next to its index, so a hit costs one cache line.
+    struct Slot {
+        VertexId id;
+        int v;
+    };
+
+    // Fibonacci hashing, top bits of the product pick the slot
+    std::size_t home(VertexId id) const {
+        return static_cast<std::size_t>((static_cast<std::uint64_t>(id) * 0x9E3779B97F4A7C15ULL) >> shift_);
+    }
+
+    // Doubles the table and reinserts the hashed ids, which are ids_ past sorted_
+    // Time - O(N)
+    void grow() {
+        std::size_t capacity = std::max<std::size_t>(16, slots_.size() * 2);
+        slots_.assign(capacity, Slot{0, -1});
+        shift_ = 64;
+        for(std::size_t c = capacity; c > 1; c >>= 1) {
+            --shift_;
+        }
+        for(std::size_t v = sorted_; v < ids_.size(); ++v) {
+            std::size_t i = home(ids_[v]);
+            while (slots_[i].v >= 0)
+            {
+                i = (i + 1) & (capacity - 1);
+            }
+            slots_[i] = Slot{ids_[v], static_cast<int>(v)};
+        }
+    }
+
+    int find_sorted(VertexId id) const {
+        auto last = ids_.begin() + sorted_;
+        auto it = std::lower_bound(ids_.begin(), last, id);
+        return it != last && *it == id ? static_cast<int>(it - ids_.begin()) : -1;
+    }
+
+    std::vector<Slot> slots_;
+    std::size_t index_size_{0};
+    int shift_{64};
+    std::vector<VertexId> ids_;
+    // ids_[0, sorted_) came from assign_sorted
+    std::size_t sorted_{0};
+};
+
+// One bit per dense vertex.
+class VisitedBitmap {
+public:
+    explicit VisitedBitmap(int n = 0)
+        : words_((n + 63) / 64, 0)
+    {}
+
+    bool test(int v) const {
+        return (words_[v >> 6] >> (v & 63)) & 1;
+    }
+
+    void set(int v) {
+        words_[v >> 6] |= std::uint64_t{1} << (v & 63);
+    }
+
+    // Returns true if v was not visited before
+    bool test_and_set(int v) {
+        std::uint64_t mask = std::uint64_t{1} << (v & 63);
+        std::uint64_t& word = words_[v >> 6];
+        bool fresh = (word & mask) == 0;
+        word |= mask;
+        return fresh;
+    }
+
+private:
+    std::vector<std::uint64_t> words_;
+};
+
+// One stamp per dense vertex; v is visited iff stamps_[v] == epoch_.
+// reset() starts a new query in O(1) instead of clearing N entries.
+class EpochVisited {
+public:
+    explicit EpochVisited(int n = 0)
+        : stamps_(n, 0)
+    {}
+
+    void resize(int n) {
+        if(n > static_cast<int>(stamps_.size())) {
+            stamps_.resize(n, 0);
+        }
+    }
+
+    void reset() {
+        if(++epoch_ == 0) {
+            std::fill(stamps_.begin(), stamps_.end(), 0);
+            epoch_ = 1;
+        }
+    }
+
+    bool test(int v) const {
+        return stamps_[v] == epoch_;
+    }
+
+    void set(int v) {
+        stamps_[v] = epoch_;
+    }
+
+    bool test_and_set(int v) {
+        if(stamps_[v] == epoch_) {
+            return false;
+        }
+        stamps_[v] = epoch_;
+        return true;
+    }
+
+private:
+    std::vector<std::uint32_t> stamps_;
+    std::uint32_t epoch_{1};
+};
+
+// Hands out traversal contexts from a free list owned by the calling thread,
+// so concurrent queries over one read-only graph never share state and no
+// query takes a lock. A context goes back to its thread's list when the
+// lease is destroyed and keeps its buffers, so a repeated query only pays
+// the O(1) epoch reset in prepare(). Nested queries get distinct contexts.
+// A lease must be destroyed on the thread that acquired it.
+template<typename Context>
+class ContextPool {
+public:
+    class Lease {
+    public:
+        explicit Lease(std::unique_ptr<Context> ctx)
+            : ctx_(std::move(ctx))
+        {}
+
+        Lease(Lease&&) = default;
+        Lease& operator=(Lease&&) = delete;
+
+        ~Lease() {
+            if(ctx_ != nullptr) {
+                free_list().push_back(std::move(ctx_));
+            }
+        }
+
+        Context& operator*() const {
+            return *ctx_;
+        }
+
+        Context* operator->() const {
+            return ctx_.get();
+        }
+
+    private:
+        std::unique_ptr<Context> ctx_;
+    };
+
+    // Time - O(1), O(N) on the first use of a context for a graph of N vertices
+    static Lease acquire() {
+        std::vector<std::unique_ptr<Context>>& list = free_list();
+        if(list.empty()) {
+            return Lease(std::make_unique<Context>());
+        }
+        std::unique_ptr<Context> ctx = std::move(list.back());
+        list.pop_back();
+        return Lease(std::move(ctx));
+    }
+
+    // Contexts parked on the calling thread
+    static std::size_t idle() {
+        return free_list().size();
+    }
+
+private:
+    static std::vector<std::unique_ptr<Context>>& free_list() {
+        thread_local std::vector<std::unique_ptr<Context>> list;
+        return list;
+    }
+};
+
+// Compressed sparse row adjacency over dense vertex indices.
+// Neighbors of v are neighbors[offsets[v]] .. neighbors[offsets[v + 1] - 1],
+// so a traversal reads one contiguous block per vertex.
+struct CsrGraph {
+    struct NeighborRange {
+        const int* first;
+        const int* last;
+
+        const int* begin() const { return first; }
+        const int* end() const { return last; }
+        int size() const { return static_cast<int>(last - first); }
+    };
+
+    int vertex_count() const {
+        return offsets.empty() ? 0 : static_cast<int>(offsets.size()) - 1;
+    }
+
+    int edge_count() const {
+        return static_cast<int>(neighbors.size());
+    }
+
+    bool contains(int v) const {
+        return v >= 0 && v < vertex_count();
+    }
+
+    NeighborRange next(int v) const {
+        const int* base = neighbors.data();
+        return NeighborRange{base + offsets[v], base + offsets[v + 1]};
+    }
+
+    // Dense index of an external id, -1 if absent
+    int dense(VertexId id) const {
+        return ids.find(id);
+    }
+
+    VertexId external(int v) const {
+        return ids.external(v);
+    }
+
+    std::vector<int> offsets;
+    std::vector<int> neighbors;
+    IdInterner ids;
+};
+
+// Two passes over interned edges, given as dense endpoint pairs in ends:
+// count degrees, then scatter.
+// Time - O(N + E)
+// Memory - O(N)
+void FillCsr(CsrGraph& ans, const std::vector<int>& ends) {
+    int n = ans.ids.size();
+    ans.offsets.assign(n + 1, 0);
+    for(int v : ends) {
+        ++ans.offsets[v + 1];
+    }
+    for(int v = 0; v < n; ++v) {
+        ans.offsets[v + 1] += ans.offsets[v];
+    }
+
+    ans.neighbors.resize(ans.offsets.back());
+    std::vector<int> cursor(ans.offsets.begin(), ans.offsets.end() - 1);
+    for(std::size_t i = 0; i < ends.size(); i += 2) {
+        ans.neighbors[cursor[ends[i]]++] = ends[i + 1];
+        ans.neighbors[cursor[ends[i + 1]]++] = ends[i];
+    }
+}
+
+// Interns the endpoints, then fills the arrays
+// Time - O(N + E)
+// Memory - O(N + E)
+CsrGraph CreateCsrGraph(const SimpleGraph& graph) {
+    CsrGraph ans;
+    std::vector<int> ends;
+    ends.reserve(graph.size() * 2);
+    for(const Edge& edge : graph) {
+        ends.push_back(ans.ids.intern(edge.a));
+        ends.push_back(ans.ids.intern(edge.b));
+    }
+    FillCsr(ans, ends);
+    return ans;
+}
+
+// Runs f(t) for every t in [0, threads), t = 0 on the calling thread
+template<typename F>
+void RunParallel(int threads, F&& f) {
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    for(int t = 1; t < threads; ++t) {
+        workers.emplace_back([&f, t] { f(t); });
+    }
+    f(0);
+    for(std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+// Start of part t when [0, n) is cut into `parts` near-equal ranges
+inline std::size_t SplitPoint(std::size_t n, int t, int parts) {
+    return n * t / parts;
+}
+
+// Inclusive prefix sum: per-range totals, a scan over the T totals, then
+// every range adds its base
+// Time - O(N / T + T)
+void ParallelPrefixSum(std::vector<int>& values, int threads) {
+    std::vector<long long> totals(threads + 1, 0);
+    RunParallel(threads, [&](int t) {
+        long long sum = 0;
+        for(std::size_t i = SplitPoint(values.size(), t, threads); i < SplitPoint(values.size(), t + 1, threads); ++i) {
+            sum += values[i];
+        }
+        totals[t + 1] = sum;
+    });
+    for(int t = 0; t < threads; ++t) {
+        totals[t + 1] += totals[t];
+    }
+    RunParallel(threads, [&](int t) {
+        int sum = static_cast<int>(totals[t]);
+        for(std::size_t i = SplitPoint(values.size(), t, threads); i < SplitPoint(values.size(), t + 1, threads); ++i) {
+            sum += values[i];
+            values[i] = sum;
+        }
+    });
+}
+
+// The graph of CreateCsrGraph up to a relabeling of the dense ids, built by
+// T threads without atomics or locks. Dense ids follow sorted external id
+// order where CreateCsrGraph numbers vertices first-seen, so the offsets
+// and neighbors arrays differ; each vertex, looked up by external id, has
+// the same degree and the same neighbours, in the same order unless dedupe
+// is on.
+// The build:
+//  1. every thread sorts the endpoints of its slice of edges together with
+//     their slots; the deduped runs are merged pairwise into the dense ids,
+//     in id order
+//  2. every thread walks its sorted endpoints alongside the ids, so each
+//     endpoint gets its dense id from a sequential scan, not a search
+//  3. every thread counts the degrees of its slice into a private
+//     histogram; per vertex, a scan over the T histograms plus the prefix
+//     sum of the degrees turns them into private write cursors
+//  4. every thread scatters its slice through its own cursors
+// Neighbours keep edge order, as in the serial build. With dedupe every
+// list is sorted and repeats are dropped, like the unordered_set in
+// CreateGraph does.
+// Offsets are int, so the graph is limited to 2^31 - 1 neighbour entries.
+// Time - O(E log E / T + N * T) work per thread
+// Memory - O(E + N * T)
+CsrGraph CreateCsrGraphParallel(const SimpleGraph& graph, bool dedupe = false,
+                                int threads = static_cast<int>(std::thread::hardware_concurrency())) {
+    threads = std::max(1, threads);
+    const std::size_t m = graph.size();
+    auto first_edge = [&](int t) { return SplitPoint(m, t, threads); };
+
+    // Endpoint ids with their slot in ends: 2 * edge, +1 for b
+    struct Endpoint {
+        VertexId id;
+        std::size_t slot;
+
+        bool operator<(const Endpoint& o) const {
+            return id < o.id;
+        }
+    };
+    std::vector<std::vector<Endpoint>> endpoints(threads);
+    std::vector<std::vector<VertexId>> runs(threads);
+    RunParallel(threads, [&](int t) {
+        std::vector<Endpoint>& own = endpoints[t];
+        own.reserve((first_edge(t + 1) - first_edge(t)) * 2);
+        for(std::size_t i = first_edge(t); i < first_edge(t + 1); ++i) {
+            own.push_back({graph[i].a, 2 * i});
+            own.push_back({graph[i].b, 2 * i + 1});
+        }
+        std::sort(own.begin(), own.end());
+        for(const Endpoint& e : own) {
+            if(runs[t].empty() || runs[t].back() != e.id) {
+                runs[t].push_back(e.id);
+            }
+        }
+    });
+    for(int width = 1; width < threads; width *= 2) {
+        RunParallel(threads, [&](int t) {
+            if(t % (2 * width) != 0 || t + width >= threads) {
+                return;
+            }
+            std::vector<VertexId> merged(runs[t].size() + runs[t + width].size());
+            merged.erase(std::set_union(runs[t].begin(), runs[t].end(), runs[t + width].begin(), runs[t + width].end(),
+                                        merged.begin()), merged.end());
+            runs[t] = std::move(merged);
+            runs[t + width] = std::vector<VertexId>();
+        });
+    }
+
+    CsrGraph ans;
+    const std::vector<VertexId>& ids = runs[0];
+    const int n = static_cast<int>(ids.size());
+    auto first_vertex = [&](int t) { return static_cast<int>(SplitPoint(n, t, threads)); };
+
+    std::vector<int> ends(m * 2);
+    std::vector<std::vector<int>> cursors(threads);
+    RunParallel(threads, [&](int t) {
+        std::vector<int>& count = cursors[t];
+        count.assign(n, 0);
+        const std::vector<Endpoint>& own = endpoints[t];
+        if(own.empty()) {
+            return;
+        }
+        int v = static_cast<int>(std::lower_bound(ids.begin(), ids.end(), own[0].id) - ids.begin());
+        for(const Endpoint& e : own) {
+            while (ids[v] != e.id)
+            {
+                ++v;
+            }
+            ends[e.slot] = v;
+            ++count[v];
+        }
+        endpoints[t] = std::vector<Endpoint>();
+    });
+
+    ans.offsets.assign(n + 1, 0);
+    RunParallel(threads, [&](int t) {
+        for(int v = first_vertex(t); v < first_vertex(t + 1); ++v) {
+            int degree = 0;
+            for(std::vector<int>& count : cursors) {
+                int own = count[v];
+                count[v] = degree;
+                degree += own;
+            }
+            ans.offsets[v + 1] = degree;
+        }
+    });
+    ParallelPrefixSum(ans.offsets, threads);
+
+    ans.neighbors.resize(ans.offsets.back());
+    RunParallel(threads, [&](int t) {
+        for(int v = first_vertex(t); v < first_vertex(t + 1); ++v) {
+            for(std::vector<int>& count : cursors) {
+                count[v] += ans.offsets[v];
+            }
+        }
+    });
+    RunParallel(threads, [&](int t) {
+        std::vector<int>& cursor = cursors[t];
+        for(std::size_t i = first_edge(t); i < first_edge(t + 1); ++i) {
+            ans.neighbors[cursor[ends[2 * i]]++] = ends[2 * i + 1];
+            ans.neighbors[cursor[ends[2 * i + 1]]++] = ends[2 * i];
+        }
+    });
+    cursors.clear();
+    ends = std::vector<int>();
+
+    if(dedupe) {
+        // Vertex ranges of about equal neighbour volume
+        std::vector<int> bounds(threads + 1, n);
+        for(int t = 0; t < threads; ++t) {
+            int target = static_cast<int>(SplitPoint(ans.neighbors.size(), t, threads));
+            bounds[t] = static_cast<int>(std::lower_bound(ans.offsets.begin(), ans.offsets.end() - 1, target) - ans.offsets.begin());
+        }
+        std::vector<int> kept(n + 1, 0);
+        RunParallel(threads, [&](int t) {
+            for(int v = bounds[t]; v < bounds[t + 1]; ++v) {
+                auto first = ans.neighbors.begin() + ans.offsets[v];
+                auto last = ans.neighbors.begin() + ans.offsets[v + 1];
+                std::sort(first, last);
+                kept[v + 1] = static_cast<int>(std::unique(first, last) - first);
+            }
+        });
+        ParallelPrefixSum(kept, threads);
+
+        std::vector<int> compact(kept.back());
+        RunParallel(threads, [&](int t) {
+            for(int v = bounds[t]; v < bounds[t + 1]; ++v) {
+                std::copy_n(ans.neighbors.begin() + ans.offsets[v], kept[v + 1] - kept[v], compact.begin() + kept[v]);
+            }
+        });
+        ans.offsets = std::move(kept);
+        ans.neighbors = std::move(compact);
+    }
+
+    ans.ids.assign_sorted(std::move(runs[0]));
+    return ans;
+}
+
+// Visitors are called once per reached vertex with its dense index and are
+// passed by template parameter, so the per-vertex action is inlined.
+struct NullVisitor {
+    void operator()(int) const {}
+};
+
+// Formats external ids into a local buffer and hands it to the stream in large
+// blocks, instead of flushing with std::endl after every vertex.
+class PrintVisitor {
+public:
+    PrintVisitor(const CsrGraph& graph, std::ostream& out)
+        : graph_(graph)
+        , out_(out)
+    {}
+
+    PrintVisitor(const PrintVisitor&) = delete;
+    PrintVisitor& operator=(const PrintVisitor&) = delete;
+
+    ~PrintVisitor() {
+        flush();
+    }
+
+    void operator()(int v) {
+        // 20 digits, sign and newline
+        if(buffer_.size() - used_ < 22) {
+            flush();
+        }
+
+        char* first = buffer_.data() + used_;
+        char* last = std::to_chars(first, buffer_.data() + buffer_.size(), graph_.external(v)).ptr;
+        *last++ = '\n';
+        used_ = last - buffer_.data();
+    }
+
+    void flush() {
+        out_.write(buffer_.data(), used_);
+        used_ = 0;
+    }
+
+private:
+    const CsrGraph& graph_;
+    std::ostream& out_;
+    std::array<char, 1 << 14> buffer_;
+    std::size_t used_{0};
+};
+
 // (N, E)
 // Time - O(N * E)
 // Memory - O(N)
-VisitedSet visited;
-void dfs(int node, Graph& graph) {
-    if(visited.find(node) != visited.end()) {
+template<typename Visitor>
+void dfs(VertexId node, const Graph& graph, VisitedSet& visited, Visitor& visit) {
+    if(!visited.insert(node).second) {
+        return;
+    }
+
+    visit(node);
+
+    for(VertexId n : Neighbors(graph, node)) {
+        dfs(n, graph, visited, visit);
+    }
+}
+
+template<typename Visitor>
+void dfs(VertexId node, const Graph& graph, Visitor&& visit) {
+    VisitedSet visited;
+    dfs(node, graph, visited, visit);
+}
+
+void dfs(VertexId node, const Graph& graph) {
+    dfs(node, graph, [](VertexId n) { std::cout << n << '\n'; });
+}
+
+// Time - O(N + E)
+// Memory - O(N)
+template<typename Visitor>
+void dfs_iterative(VertexId node, const Graph& graph, Visitor&& visit) {
+    using Iterator = std::unordered_set<VertexId>::const_iterator;
+    struct Frame {
+        Iterator curr;
+        Iterator end;
+    };
+
+    VisitedSet seen;
+    std::vector<Frame> stack;
+
+    seen.insert(node);
+    visit(node);
+    const auto& first = Neighbors(graph, node);
+    stack.push_back(Frame{first.begin(), first.end()});
+
+    while (!stack.empty())
+    {
+        Frame& top = stack.back();
+        if(top.curr == top.end) {
+            stack.pop_back();
+            continue;
+        }
+
+        VertexId n = *top.curr;
+        ++top.curr;
+        if(!seen.insert(n).second) {
+            continue;
+        }
+
+        visit(n);
+        const auto& next = Neighbors(graph, n);
+        stack.push_back(Frame{next.begin(), next.end()});
+    }
+}
+
+void dfs_iterative(VertexId node, const Graph& graph) {
+    dfs_iterative(node, graph, [](VertexId n) { std::cout << n << '\n'; });
+}
+
+// Caller-owned DFS state: an explicit stack of (node, neighbor cursor) frames
+// and epoch-stamped visited marks. Reusing one context for repeated queries on
+// the same graph does not allocate after the first query.
+struct DfsContext {
+    struct Frame {
+        int node;
+        int cursor;
+    };
+
+    void prepare(const CsrGraph& graph) {
+        int n = graph.vertex_count();
+        visited.resize(n);
+        visited.reset();
+        stack.clear();
+        if(static_cast<int>(stack.capacity()) < n) {
+            stack.reserve(n);
+        }
+    }
+
+    std::vector<Frame> stack;
+    EpochVisited visited;
+};
+
+// Time - O(N + E)
+// Memory - O(N)
+// Marks is VisitedBitmap or EpochVisited
+template<typename Marks, typename Visitor>
+void dfs(int node, const CsrGraph& graph, Marks& visited, Visitor& visit) {
+    if(!visited.test_and_set(node)) {
+        return;
+    }
+
+    visit(node);
+
+    for(int n : graph.next(node)) {
+        dfs(n, graph, visited, visit);
+    }
+}
+
+template<typename Visitor>
+void dfs(VertexId start, const CsrGraph& graph, Visitor&& visit) {
+    int node = graph.dense(start);
+    if(node < 0) {
+        return;
+    }
+
+    // Only the marks: a DfsContext would also reserve an N-frame stack that
+    // recursion never uses, and keep it in the pool
+    auto visited = ContextPool<EpochVisited>::acquire();
+    visited->resize(graph.vertex_count());
+    visited->reset();
+    dfs(node, graph, *visited, visit);
+}
+
+void dfs(VertexId start, const CsrGraph& graph) {
+    dfs(start, graph, PrintVisitor(graph, std::cout));
+}
+
+// Visits every vertex reachable from the dense index `node` in the same order
+// as the recursive dfs. pre(v) runs when v is discovered, post(v) once all of
+// its neighbors are done.
+// Time - O(N + E)
+// Memory - O(1) beyond the context
+template<typename PreOrder, typename PostOrder>
+void dfs_iterative(int node, const CsrGraph& graph, DfsContext& ctx, PreOrder&& pre, PostOrder&& post) {
+    ctx.prepare(graph);
+    if(!graph.contains(node)) {
         return;
     }
 
-    std::cout << node << std::endl;
-    visited.insert(node);
+    const int* offsets = graph.offsets.data();
+    const int* neighbors = graph.neighbors.data();
 
-    const std::unordered_set<int>& next = graph[node];
-    for(int n : next) {
-        dfs(n, graph);
+    ctx.visited.set(node);
+    pre(node);
+    ctx.stack.push_back(DfsContext::Frame{node, offsets[node]});
+
+    while (!ctx.stack.empty())
+    {
+        DfsContext::Frame& top = ctx.stack.back();
+        if(top.cursor == offsets[top.node + 1]) {
+            post(top.node);
+            ctx.stack.pop_back();
+            continue;
+        }
+
+        int n = neighbors[top.cursor++];
+        if(ctx.visited.test_and_set(n)) {
+            pre(n);
+            ctx.stack.push_back(DfsContext::Frame{n, offsets[n]});
+        }
     }
 }
 
-void dfs_iterative(int node, Graph& graph) {
-    // TODO
+void dfs_iterative(VertexId start, const CsrGraph& graph, DfsContext& ctx) {
+    PrintVisitor print(graph, std::cout);
+    dfs_iterative(graph.dense(start), graph, ctx, print, NullVisitor{});
+}
+
+void dfs_iterative(VertexId start, const CsrGraph& graph) {
+    auto ctx = ContextPool<DfsContext>::acquire();
+    dfs_iterative(start, graph, *ctx);
 }
 
-int bfs(int begin, int end, Graph& graph) {
-    std::queue<int> q;
+template<typename Visitor>
+int bfs(VertexId begin, VertexId end, const Graph& graph, Visitor&& visit) {
+    // Marked when pushed, so every vertex enters the queue once
+    VisitedSet visited;
+    std::queue<VertexId> q;
     int level = 0;
     q.push(begin);
+    visited.insert(begin);
     while (!q.empty())
     {
         int cnt = q.size();
         while (cnt > 0)
         {
-            int curr = q.front();
+            VertexId curr = q.front();
             q.pop();
+            --cnt;
 
             if(curr == end){
                 return level;
             }
 
-            if(visited.find(curr) != visited.end()) {
-                continue;
-            }
+            visit(curr);
 
-            std::cout << curr << std::endl;
-            visited.insert(curr);
-
-            const std::unordered_set<int>& next = graph[curr];
-            for(int n : next) {
-                q.push(n);
+            for(VertexId n : Neighbors(graph, curr)) {
+                if(visited.insert(n).second) {
+                    q.push(n);
+                }
             }
-            --cnt;
         }
         ++level;
     }
     return -1;
 }
 
-int main() {
-    SimpleGraph edges {
-        Edge{1, 2},
-        Edge{1, 3},
-        Edge{2, 3},
-        Edge{3, 4},
-        Edge{3, 5},
-        // Edge{3, 7},
-        Edge{4, 5},
-        Edge{6, 7}
-    };
+int bfs(VertexId begin, VertexId end, const Graph& graph) {
+    return bfs(begin, end, graph, [](VertexId n) { std::cout << n << '\n'; });
+}
 
-    auto graph = CreateGraph(edges);
-    dfs(1, graph);
+// Shape of one BFS run: frontier[i] vertices were expanded on level i, in
+// the direction bottom_up[i] says, and edges_inspected counts every
+// adjacency entry read. Filled only in UFAR_STATS builds.
+struct BfsStats {
+    void clear() {
+        frontier.clear();
+        bottom_up.clear();
+        edges_inspected = 0;
+        direction_switches = 0;
+    }
 
-    std::cout << "-----------------------" << std::endl;
+    // Time - O(1) amortized
+    void expand(int level, long long degree) {
+        if(level >= static_cast<int>(frontier.size())) {
+            frontier.resize(level + 1, 0);
+            bottom_up.resize(level + 1, 0);
+        }
+        ++frontier[level];
+        edges_inspected += degree;
+    }
+
+    StatsSnapshot snapshot(const std::string& prefix = "bfs") const {
+        StatsSnapshot ans;
+        if(frontier.empty()) {
+            return ans;
+        }
+        ans.add(prefix + ".levels", static_cast<double>(frontier.size()));
+        ans.add(prefix + ".edges_inspected", static_cast<double>(edges_inspected));
+        ans.add(prefix + ".direction_switches", direction_switches);
+        for(std::size_t i = 0; i < frontier.size(); ++i) {
+            std::string level = prefix + ".level." + std::to_string(i);
+            ans.add(level + ".frontier", static_cast<double>(frontier[i]));
+            ans.add(level + ".bottom_up", bottom_up[i]);
+        }
+        return ans;
+    }
+
+    std::vector<long long> frontier;
+    std::vector<char> bottom_up;
+    long long edges_inspected{0};
+    int direction_switches{0};
+};
 
-    // visited.clear();
-    // bfs(1, graph);
+// Reusable BFS state. Vertices are marked when enqueued, so each one enters
+// the queue at most once and a flat array of N slots is a bounded frontier:
+// [head, tail) is the live queue and level_end marks where the current
+// level stops. No allocation after the first query on a graph.
+struct BfsContext {
+    void prepare(const CsrGraph& graph) {
+        int n = graph.vertex_count();
+        if(static_cast<int>(queue.size()) < n) {
+            queue.resize(n);
+        }
+        visited.resize(n);
+        visited.reset();
+        head = 0;
+        tail = 0;
+        UFAR_STAT(stats.clear();)
+    }
+
+    void push(int v) {
+        queue[tail++] = v;
+    }
+
+    // The last bfs run on this context, empty unless built with UFAR_STATS
+    StatsSnapshot stats_snapshot(const std::string& prefix = "bfs") const {
+#if defined(UFAR_STATS)
+        return stats.snapshot(prefix);
+#else
+        (void)prefix;
+        return StatsSnapshot();
+#endif
+    }
+
+    std::vector<int> queue;
+    EpochVisited visited;
+    int head{0};
+    int tail{0};
+    UFAR_STAT(BfsStats stats;)
+};
+
+// Calls visit(v) in BFS order and on_level(v, level) as each vertex is
+// discovered. Stops once `target` (dense, -1 for none) is dequeued and
+// returns its level, -1 if it was not reached.
+// Time - O(N + E)
+// Memory - O(1) beyond the context
+template<typename Visitor, typename OnLevel>
+int bfs(int source, int target, const CsrGraph& graph, BfsContext& ctx, Visitor&& visit, OnLevel&& on_level) {
+    ctx.prepare(graph);
+    if(!graph.contains(source)) {
+        return -1;
+    }
+
+    int level = 0;
+    ctx.visited.set(source);
+    ctx.push(source);
+    on_level(source, 0);
+
+    int level_end = ctx.tail;
+    while (ctx.head < ctx.tail)
+    {
+        if(ctx.head == level_end) {
+            ++level;
+            level_end = ctx.tail;
+        }
+
+        int curr = ctx.queue[ctx.head++];
+        if(curr == target) {
+            return level;
+        }
+
+        visit(curr);
+        UFAR_STAT(ctx.stats.expand(level, graph.next(curr).size());)
+
+        for(int n : graph.next(curr)) {
+            if(ctx.visited.test_and_set(n)) {
+                ctx.push(n);
+                on_level(n, level + 1);
+            }
+        }
+    }
+    return -1;
+}
+
+template<typename Visitor>
+int bfs(VertexId begin, VertexId end, const CsrGraph& graph, Visitor&& visit) {
+    int source = graph.dense(begin);
+    int target = graph.dense(end);
+    if(source < 0 || target < 0) {
+        return -1;
+    }
+
+    auto ctx = ContextPool<BfsContext>::acquire();
+    return bfs(source, target, graph, *ctx, visit, [](int, int) {});
+}
+
+// Level of every dense vertex, -1 if unreachable
+std::vector<int> bfs_levels(VertexId begin, const CsrGraph& graph, BfsContext& ctx) {
+    std::vector<int> levels(graph.vertex_count(), -1);
+    bfs(graph.dense(begin), -1, graph, ctx, NullVisitor{},
+        [&](int v, int level) { levels[v] = level; });
+    return levels;
+}
+
+int bfs(VertexId begin, VertexId end, const CsrGraph& graph) {
+    return bfs(begin, end, graph, PrintVisitor(graph, std::cout));
+}
+
+// Reusable barrier for a fixed group of threads
+class Barrier {
+public:
+    explicit Barrier(int count)
+        : count_(count)
+    {}
+
+    void arrive_and_wait() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        std::uint64_t generation = generation_;
+        if(++arrived_ == count_) {
+            arrived_ = 0;
+            ++generation_;
+            cv_.notify_all();
+            return;
+        }
+        cv_.wait(lock, [&] { return generation != generation_; });
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    int count_;
+    int arrived_{0};
+    std::uint64_t generation_{0};
+};
+
+// Direction-optimizing BFS (Beamer et al.).
+// Top-down steps expand a sparse frontier and claim vertices with a CAS on
+// their level. Once the frontier's edges outweigh the unvisited edges by
+// kAlpha, bottom-up steps scan unvisited vertices instead and stop at the
+// first parent found in the frontier bitmap. Each thread owns a range of
+// 64-vertex words there, so the next bitmap is written without atomics.
+// Returns the level of every dense vertex, -1 if unreachable. In
+// UFAR_STATS builds, `stats` (if given) receives the per-level frontier
+// sizes and directions, the edges inspected and the direction switches.
+// Time - O(N + E) work, O(D) barrier rounds
+// Memory - O(N)
+std::vector<int> parallel_bfs(VertexId begin, const CsrGraph& graph,
+                              int threads = static_cast<int>(std::thread::hardware_concurrency()),
+                              BfsStats* stats = nullptr) {
+    constexpr long long kAlpha = 14;
+    constexpr int kBeta = 24;
+
+    const int n = graph.vertex_count();
+    const int source = graph.dense(begin);
+    if(source < 0) {
+        return std::vector<int>(n, -1);
+    }
+
+    threads = std::max(1, threads);
+    const int words = (n + 63) / 64;
+
+    std::vector<std::atomic<int>> levels(n);
+    std::vector<std::uint64_t> front_bits(words, 0);
+    std::vector<std::uint64_t> next_bits(words, 0);
+    std::vector<int> frontier{source};
+    std::vector<std::vector<int>> local_next(threads);
+    std::vector<long long> local_degree(threads, 0);
+    (void)stats;
+    UFAR_STAT(std::vector<long long> local_edges(threads, 0);)
+    UFAR_STAT(if(stats != nullptr) { stats->clear(); stats->expand(0, 0); })
+
+    long long frontier_edges = graph.next(source).size();
+    long long unvisited_edges = graph.edge_count() - frontier_edges;
+    bool bottom_up = false;
+    bool done = false;
+    int level = 0;
+
+    Barrier barrier(threads);
+
+    auto worker = [&](int t) {
+        const int word_first = static_cast<int>(static_cast<long long>(words) * t / threads);
+        const int word_last = static_cast<int>(static_cast<long long>(words) * (t + 1) / threads);
+        const int vertex_first = word_first * 64;
+        const int vertex_last = std::min(n, word_last * 64);
+
+        for(int v = vertex_first; v < vertex_last; ++v) {
+            levels[v].store(-1, std::memory_order_relaxed);
+        }
+        barrier.arrive_and_wait();
+        if(t == 0) {
+            levels[source].store(0, std::memory_order_relaxed);
+        }
+        barrier.arrive_and_wait();
+
+        while (!done)
+        {
+            std::vector<int>& next = local_next[t];
+            next.clear();
+            long long degree = 0;
+            UFAR_STAT(long long inspected = 0;)
+
+            if(!bottom_up) {
+                const int size = static_cast<int>(frontier.size());
+                const int first = static_cast<int>(static_cast<long long>(size) * t / threads);
+                const int last = static_cast<int>(static_cast<long long>(size) * (t + 1) / threads);
+                for(int i = first; i < last; ++i) {
+                    UFAR_STAT(inspected += graph.next(frontier[i]).size();)
+                    for(int u : graph.next(frontier[i])) {
+                        int expected = -1;
+                        if(levels[u].load(std::memory_order_relaxed) == -1 &&
+                           levels[u].compare_exchange_strong(expected, level + 1, std::memory_order_relaxed)) {
+                            next.push_back(u);
+                            degree += graph.next(u).size();
+                        }
+                    }
+                }
+            } else {
+                for(int w = word_first; w < word_last; ++w) {
+                    std::uint64_t out = 0;
+                    const int last = std::min(n, (w + 1) * 64);
+                    for(int v = w * 64; v < last; ++v) {
+                        if(levels[v].load(std::memory_order_relaxed) != -1) {
+                            continue;
+                        }
+                        for(int u : graph.next(v)) {
+                            UFAR_STAT(++inspected;)
+                            if((front_bits[u >> 6] >> (u & 63)) & 1) {
+                                levels[v].store(level + 1, std::memory_order_relaxed);
+                                out |= std::uint64_t{1} << (v & 63);
+                                next.push_back(v);
+                                degree += graph.next(v).size();
+                                break;
+                            }
+                        }
+                    }
+                    next_bits[w] = out;
+                }
+            }
+            local_degree[t] = degree;
+            UFAR_STAT(local_edges[t] = inspected;)
+
+            barrier.arrive_and_wait();
+
+            if(t == 0) {
+                long long next_edges = 0;
+                std::size_t next_size = 0;
+                for(int i = 0; i < threads; ++i) {
+                    next_edges += local_degree[i];
+                    next_size += local_next[i].size();
+                }
+                unvisited_edges -= next_edges;
+                frontier_edges = next_edges;
+
+                bool was_bottom_up = bottom_up;
+                if(!bottom_up && frontier_edges * kAlpha > unvisited_edges) {
+                    bottom_up = true;
+                } else if(bottom_up && next_size * kBeta < static_cast<std::size_t>(n)) {
+                    bottom_up = false;
+                }
+#if defined(UFAR_STATS)
+                if(stats != nullptr) {
+                    stats->bottom_up[level] = was_bottom_up;
+                    for(long long edges : local_edges) {
+                        stats->edges_inspected += edges;
+                    }
+                    stats->direction_switches += bottom_up != was_bottom_up && next_size != 0;
+                    if(next_size != 0) {
+                        stats->expand(level + 1, 0);
+                        stats->frontier[level + 1] = static_cast<long long>(next_size);
+                    }
+                }
+#endif
+
+                frontier.clear();
+                if(bottom_up && was_bottom_up) {
+                    std::swap(front_bits, next_bits);
+                } else {
+                    for(int i = 0; i < threads; ++i) {
+                        frontier.insert(frontier.end(), local_next[i].begin(), local_next[i].end());
+                    }
+                    if(bottom_up) {
+                        std::fill(front_bits.begin(), front_bits.end(), 0);
+                        for(int v : frontier) {
+                            front_bits[v >> 6] |= std::uint64_t{1} << (v & 63);
+                        }
+                    }
+                }
+
+                ++level;
+                done = next_size == 0;
+            }
+
+            barrier.arrive_and_wait();
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for(int t = 1; t < threads; ++t) {
+        pool.emplace_back(worker, t);
+    }
+    worker(0);
+    for(std::thread& thread : pool) {
+        thread.join();
+    }
+
+    std::vector<int> ans(n);
+    for(int v = 0; v < n; ++v) {
+        ans[v] = levels[v].load(std::memory_order_relaxed);
+    }
+    return ans;
+}
+
+// Union-find that many threads can unite and find in at the same time
+// (Anderson & Woll). Each vertex is one 64-bit word, rank in the high half
+// and parent in the low half, so linking a root is a single CAS that fails
+// if the root was linked or re-ranked meanwhile. Lower rank goes under
+// higher, equal ranks link the larger index under the smaller. find
+// halves paths with CAS as well; a lost race only leaves a longer path.
+class ConcurrentDisjointSets {
+public:
+    explicit ConcurrentDisjointSets(int n)
+        : words_(n)
+    {
+        for(int v = 0; v < n; ++v) {
+            words_[v].store(pack(v, 0), std::memory_order_relaxed);
+        }
+    }
+
+    // Time - O(log N) worst case, near O(1) amortized
+    int find(int v) {
+        while (true)
+        {
+            std::uint64_t word = words_[v].load(std::memory_order_acquire);
+            int p = parent(word);
+            if(p == v) {
+                return v;
+            }
+            int grand = parent(words_[p].load(std::memory_order_acquire));
+            if(grand != p) {
+                words_[v].compare_exchange_weak(word, pack(grand, rank(word)), std::memory_order_acq_rel);
+            }
+            v = grand;
+        }
+    }
+
+    // Returns true if a and b were in different sets
+    // Time - O(log N) worst case, near O(1) amortized
+    bool unite(int a, int b) {
+        while (true)
+        {
+            a = find(a);
+            b = find(b);
+            if(a == b) {
+                return false;
+            }
+            std::uint64_t word_a = words_[a].load(std::memory_order_acquire);
+            std::uint64_t word_b = words_[b].load(std::memory_order_acquire);
+            if(parent(word_a) != a || parent(word_b) != b) {
+                continue;
+            }
+            std::uint32_t rank_a = rank(word_a);
+            std::uint32_t rank_b = rank(word_b);
+            if(rank_a > rank_b || (rank_a == rank_b && a < b)) {
+                std::swap(a, b);
+                std::swap(word_a, word_b);
+                std::swap(rank_a, rank_b);
+            }
+            // a goes under b
+            if(!words_[a].compare_exchange_strong(word_a, pack(b, rank_a), std::memory_order_acq_rel)) {
+                continue;
+            }
+            if(rank_a == rank_b) {
+                words_[b].compare_exchange_strong(word_b, pack(b, rank_b + 1), std::memory_order_acq_rel);
+            }
+            return true;
+        }
+    }
+
+    bool same(int a, int b) {
+        return find(a) == find(b);
+    }
+
+private:
+    static std::uint64_t pack(int parent, std::uint32_t rank) {
+        return (static_cast<std::uint64_t>(rank) << 32) | static_cast<std::uint32_t>(parent);
+    }
+
+    static int parent(std::uint64_t word) {
+        return static_cast<int>(static_cast<std::uint32_t>(word));
+    }
+
+    static std::uint32_t rank(std::uint64_t word) {
+        return static_cast<std::uint32_t>(word >> 32);
+    }
+
+    std::vector<std::atomic<std::uint64_t>> words_;
+};
+
+// Component of every dense vertex, numbered 0..count-1 in order of each
+// component's smallest dense vertex, so labels do not depend on thread timing
+struct ComponentLabels {
+    bool connected(int a, int b) const {
+        return label[a] == label[b];
+    }
+
+    std::vector<int> label;
+    int count{0};
+};
+
+// Every thread unites the edges of its range of vertices, each undirected
+// edge once from its smaller end. Roots are then resolved in parallel and
+// numbered by one scan.
+// Time - O((N + E) / T) near-linear work, plus one O(N) numbering scan
+// Memory - O(N)
+ComponentLabels connected_components(const CsrGraph& graph,
+                                     int threads = static_cast<int>(std::thread::hardware_concurrency())) {
+    threads = std::max(1, threads);
+    const int n = graph.vertex_count();
+    auto first_vertex = [&](int t) { return static_cast<int>(SplitPoint(n, t, threads)); };
+
+    ConcurrentDisjointSets sets(n);
+    RunParallel(threads, [&](int t) {
+        for(int v = first_vertex(t); v < first_vertex(t + 1); ++v) {
+            for(int u : graph.next(v)) {
+                if(u > v) {
+                    sets.unite(v, u);
+                }
+            }
+        }
+    });
+
+    ComponentLabels ans;
+    ans.label.resize(n);
+    RunParallel(threads, [&](int t) {
+        for(int v = first_vertex(t); v < first_vertex(t + 1); ++v) {
+            ans.label[v] = sets.find(v);
+        }
+    });
+    // The scan meets every component first at its smallest vertex
+    std::vector<int> number(n, -1);
+    for(int v = 0; v < n; ++v) {
+        int& id = number[ans.label[v]];
+        if(id < 0) {
+            id = ans.count++;
+        }
+    }
+    RunParallel(threads, [&](int t) {
+        for(int v = first_vertex(t); v < first_vertex(t + 1); ++v) {
+            ans.label[v] = number[ans.label[v]];
+        }
+    });
+    return ans;
+}
+
+// Distance from every dense vertex to its nearest seed and the index of
+// that seed in `seeds`, -1 for both if no seed reaches it. Ties go to the
+// seed that comes first.
+struct NearestSeeds {
+    std::vector<int> distance;
+    std::vector<int> seed;
+};
+
+// One BFS with every seed on level 0: a vertex is claimed by whichever
+// wavefront reaches it first, which is its nearest seed. Unknown seed ids
+// are skipped.
+// Time - O(N + E), independent of the number of seeds
+// Memory - O(N) for the answer, O(1) beyond the context
+NearestSeeds multi_source_bfs(const std::vector<VertexId>& seeds, const CsrGraph& graph, BfsContext& ctx) {
+    const int n = graph.vertex_count();
+    NearestSeeds ans;
+    ans.distance.assign(n, -1);
+    ans.seed.assign(n, -1);
+
+    ctx.prepare(graph);
+    for(std::size_t i = 0; i < seeds.size(); ++i) {
+        int v = graph.dense(seeds[i]);
+        if(v >= 0 && ctx.visited.test_and_set(v)) {
+            ans.distance[v] = 0;
+            ans.seed[v] = static_cast<int>(i);
+            ctx.push(v);
+        }
+    }
+
+    while (ctx.head < ctx.tail)
+    {
+        int curr = ctx.queue[ctx.head++];
+        for(int u : graph.next(curr)) {
+            if(ctx.visited.test_and_set(u)) {
+                ans.distance[u] = ans.distance[curr] + 1;
+                ans.seed[u] = ans.seed[curr];
+                ctx.push(u);
+            }
+        }
+    }
+    return ans;
+}
+
+// Vertex orders for ReorderCsrGraph. Each returns order[new] = old dense
+// index, a permutation of [0, N), and keeps every connected component in
+// one contiguous block of new ids.
+
+// Plain BFS order: a vertex's neighbours get consecutive ids right after
+// the vertices of the previous level, so a traversal reads the neighbour
+// arrays nearly front to back.
+// Time - O(N + E)
+// Memory - O(N)
+std::vector<int> bfs_order(const CsrGraph& graph) {
+    const int n = graph.vertex_count();
+    std::vector<int> order;
+    order.reserve(n);
+    VisitedBitmap placed(n);
+    for(int root = 0; root < n; ++root) {
+        if(!placed.test_and_set(root)) {
+            continue;
+        }
+        std::size_t head = order.size();
+        order.push_back(root);
+        while (head < order.size())
+        {
+            for(int u : graph.next(order[head++])) {
+                if(placed.test_and_set(u)) {
+                    order.push_back(u);
+                }
+            }
+        }
+    }
+    return order;
+}
+
+// Reverse Cuthill-McKee. Every component starts from a pseudo-peripheral
+// vertex, the lowest-degree vertex on the last level of a BFS from the
+// component's smallest vertex, and each vertex's new neighbours are queued
+// by increasing degree. Reversing the result keeps the bandwidth
+// (max |new u - new v| over edges) small, so the endpoints of an edge
+// tend to share cache lines.
+// Time - O(N + E log D), D the largest degree
+// Memory - O(N)
+std::vector<int> rcm_order(const CsrGraph& graph) {
+    const int n = graph.vertex_count();
+    auto degree = [&](int v) { return graph.next(v).size(); };
+    auto by_degree = [&](int a, int b) { return degree(a) != degree(b) ? degree(a) < degree(b) : a < b; };
+
+    std::vector<int> order;
+    order.reserve(n);
+    std::vector<int> level_queue;
+    level_queue.reserve(n);
+    std::vector<int> fresh;
+    VisitedBitmap placed(n);
+    EpochVisited seen(n);
+    for(int root = 0; root < n; ++root) {
+        if(placed.test(root)) {
+            continue;
+        }
+
+        // Probe BFS: the last level holds the vertices farthest from root
+        seen.reset();
+        seen.set(root);
+        level_queue.assign(1, root);
+        std::size_t level_begin = 0;
+        for(std::size_t head = 0; head < level_queue.size();) {
+            level_begin = head;
+            std::size_t level_end = level_queue.size();
+            for(; head < level_end; ++head) {
+                for(int u : graph.next(level_queue[head])) {
+                    if(seen.test_and_set(u)) {
+                        level_queue.push_back(u);
+                    }
+                }
+            }
+        }
+        int start = *std::min_element(level_queue.begin() + level_begin, level_queue.end(), by_degree);
+
+        std::size_t head = order.size();
+        placed.set(start);
+        order.push_back(start);
+        while (head < order.size())
+        {
+            fresh.clear();
+            for(int u : graph.next(order[head++])) {
+                if(placed.test_and_set(u)) {
+                    fresh.push_back(u);
+                }
+            }
+            std::sort(fresh.begin(), fresh.end(), by_degree);
+            order.insert(order.end(), fresh.begin(), fresh.end());
+        }
+    }
+    std::reverse(order.begin(), order.end());
+    return order;
+}
+
+// Highest degree first, ties by old index. Hubs are touched by most
+// traversals, so packing them together keeps their marks and offsets in
+// a few hot cache lines.
+// Time - O(N log N)
+// Memory - O(N)
+std::vector<int> degree_order(const CsrGraph& graph) {
+    std::vector<int> order(graph.vertex_count());
+    for(int v = 0; v < graph.vertex_count(); ++v) {
+        order[v] = v;
+    }
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return graph.next(a).size() > graph.next(b).size(); });
+    return order;
+}
+
+// Max |u - v| over all edges
+// Time - O(E)
+int bandwidth(const CsrGraph& graph) {
+    int ans = 0;
+    for(int v = 0; v < graph.vertex_count(); ++v) {
+        for(int u : graph.next(v)) {
+            ans = std::max(ans, u > v ? u - v : v - u);
+        }
+    }
+    return ans;
+}
+
+// Same graph with dense vertex order[i] renamed to i. External ids move
+// with their vertices, so dense()/external() keep mapping to the original
+// ids; order[v] maps a new dense index back to the old one. Every
+// neighbour list is sorted by new index, so a traversal walks memory
+// forwards.
+// Time - O(N + E log D)
+// Memory - O(N + E)
+CsrGraph ReorderCsrGraph(const CsrGraph& graph, const std::vector<int>& order) {
+    const int n = graph.vertex_count();
+    std::vector<int> new_of(n);
+    for(int i = 0; i < n; ++i) {
+        new_of[order[i]] = i;
+    }
+
+    CsrGraph ans;
+    ans.offsets.assign(n + 1, 0);
+    for(int i = 0; i < n; ++i) {
+        ans.offsets[i + 1] = ans.offsets[i] + graph.next(order[i]).size();
+    }
+    ans.neighbors.resize(graph.edge_count());
+    for(int i = 0; i < n; ++i) {
+        int* out = ans.neighbors.data() + ans.offsets[i];
+        for(int u : graph.next(order[i])) {
+            *out++ = new_of[u];
+        }
+        std::sort(ans.neighbors.data() + ans.offsets[i], out);
+        ans.ids.intern(graph.external(order[i]));
+    }
+    return ans;
+}
+
+using Weight = std::int64_t;
+
+constexpr Weight kInfinity = std::numeric_limits<Weight>::max();
+
+// Road between a and b with a non-negative cost (length, travel time, ...)
+struct WeightedEdge {
+    VertexId a;
+    VertexId b;
+    Weight w;
+};
+
+using WeightedSimpleGraph = std::vector<WeightedEdge>;
+
+// CSR with targets and weights in parallel arrays
+struct WeightedAdjacency {
+    int begin(int v) const { return offsets[v]; }
+    int end(int v) const { return offsets[v + 1]; }
+
+    std::vector<int> offsets;
+    std::vector<int> targets;
+    std::vector<Weight> weights;
+};
+
+// Weighted CSR graph over dense vertex indices. For a directed graph the
+// reverse adjacency is kept as well, so searches can run backwards from
+// the target.
+struct WeightedCsrGraph {
+    int vertex_count() const {
+        return ids.size();
+    }
+
+    bool contains(int v) const {
+        return v >= 0 && v < vertex_count();
+    }
+
+    const WeightedAdjacency& backward() const {
+        return directed ? reverse : forward;
+    }
+
+    int dense(VertexId id) const {
+        return ids.find(id);
+    }
+
+    VertexId external(int v) const {
+        return ids.external(v);
+    }
+
+    WeightedAdjacency forward;
+    WeightedAdjacency reverse;
+    IdInterner ids;
+    bool directed{false};
+};
+
+// Time - O(N + E)
+// Memory - O(N + E)
+void FillAdjacency(WeightedAdjacency& adj, int n, const std::vector<int>& from,
+                   const std::vector<int>& to, const std::vector<Weight>& w) {
+    adj.offsets.assign(n + 1, 0);
+    for(int v : from) {
+        ++adj.offsets[v + 1];
+    }
+    for(int v = 0; v < n; ++v) {
+        adj.offsets[v + 1] += adj.offsets[v];
+    }
+
+    adj.targets.resize(from.size());
+    adj.weights.resize(from.size());
+    std::vector<int> cursor(adj.offsets.begin(), adj.offsets.end() - 1);
+    for(std::size_t i = 0; i < from.size(); ++i) {
+        int slot = cursor[from[i]]++;
+        adj.targets[slot] = to[i];
+        adj.weights[slot] = w[i];
+    }
+}
+
+// Arcs between dense vertices, collected before the adjacency is filled
+struct ArcList {
+    void reserve(std::size_t edges, bool directed) {
+        std::size_t arcs = directed ? edges : edges * 2;
+        from.reserve(arcs);
+        to.reserve(arcs);
+        w.reserve(arcs);
+    }
+
+    void add(int a, int b, Weight weight, bool directed) {
+        from.push_back(a);
+        to.push_back(b);
+        w.push_back(weight);
+        if(!directed) {
+            from.push_back(b);
+            to.push_back(a);
+            w.push_back(weight);
+        }
+    }
+
+    std::vector<int> from;
+    std::vector<int> to;
+    std::vector<Weight> w;
+};
+
+// Time - O(N + E)
+// Memory - O(N + E)
+void FillWeightedCsr(WeightedCsrGraph& ans, const ArcList& arcs) {
+    FillAdjacency(ans.forward, ans.vertex_count(), arcs.from, arcs.to, arcs.w);
+    if(ans.directed) {
+        FillAdjacency(ans.reverse, ans.vertex_count(), arcs.to, arcs.from, arcs.w);
+    }
+}
+
+// Time - O(N + E)
+// Memory - O(N + E)
+WeightedCsrGraph CreateWeightedCsrGraph(const WeightedSimpleGraph& graph, bool directed = false) {
+    WeightedCsrGraph ans;
+    ans.directed = directed;
+
+    ArcList arcs;
+    arcs.reserve(graph.size(), directed);
+    for(const WeightedEdge& edge : graph) {
+        int a = ans.ids.intern(edge.a);
+        int b = ans.ids.intern(edge.b);
+        arcs.add(a, b, edge.w, directed);
+    }
+    FillWeightedCsr(ans, arcs);
+    return ans;
+}
+
+// Splits edge-list text into rows of integers, reading the bytes in place.
+// Rows are lines; fields are separated by spaces, tabs, commas or
+// semicolons. Lines starting with '#' or '%' (SNAP, Matrix Market) and
+// lines that do not start with a number, such as a CSV header, are
+// skipped, as are rows with too few fields. Extra fields are ignored.
+// Runs of 8 digits are converted at once with SWAR arithmetic.
+class EdgeListParser {
+public:
+    EdgeListParser(const char* first, const char* last)
+        : p_(first)
+        , end_(last)
+    {}
+
+    // Reads the first `columns` integers of the next valid row
+    // Time - O(row length)
+    bool next(std::int64_t* values, int columns) {
+        while (p_ < end_)
+        {
+            while (p_ < end_ && is_separator(*p_))
+            {
+                ++p_;
+            }
+            int read = 0;
+            while (read < columns && p_ < end_ && starts_number(p_))
+            {
+                values[read++] = parse(p_);
+                while (p_ < end_ && is_separator(*p_))
+                {
+                    ++p_;
+                }
+            }
+            skip_line();
+            if(read == columns) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    static bool is_separator(char c) {
+        return c == ' ' || c == '\t' || c == ',' || c == ';' || c == '\r';
+    }
+
+    static bool is_digit(char c) {
+        return static_cast<unsigned char>(c - '0') < 10;
+    }
+
+    bool starts_number(const char* p) const {
+        return is_digit(*p) || (*p == '-' && p + 1 < end_ && is_digit(p[1]));
+    }
+
+    void skip_line() {
+        while (p_ < end_ && *p_ != '\n')
+        {
+            ++p_;
+        }
+        if(p_ < end_) {
+            ++p_;
+        }
+    }
+
+    // True if all 8 bytes are '0'..'9'
+    static bool eight_digits(std::uint64_t chunk) {
+        return ((chunk & 0xF0F0F0F0F0F0F0F0ULL) |
+                (((chunk + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4)) == 0x3333333333333333ULL;
+    }
+
+    // 8 ASCII digits, first digit in the lowest byte, to their value:
+    // three multiply-add rounds join pairs, then quads, then both halves
+    static std::uint64_t eight_digit_value(std::uint64_t chunk) {
+        chunk -= 0x3030303030303030ULL;
+        chunk = (chunk * 10 + (chunk >> 8)) & 0x00FF00FF00FF00FFULL;
+        chunk = (chunk * 100 + (chunk >> 16)) & 0x0000FFFF0000FFFFULL;
+        return (chunk * 10000 + (chunk >> 32)) & 0xFFFFFFFFULL;
+    }
+
+    std::int64_t parse(const char*& p) const {
+        bool negative = *p == '-';
+        p += negative;
+        std::uint64_t value = 0;
+        std::uint64_t chunk;
+        while (p + 8 <= end_ && (std::memcpy(&chunk, p, 8), eight_digits(chunk)))
+        {
+            value = value * 100000000 + eight_digit_value(chunk);
+            p += 8;
+        }
+        while (p < end_ && is_digit(*p))
+        {
+            value = value * 10 + static_cast<std::uint64_t>(*p - '0');
+            ++p;
+        }
+        return negative ? -static_cast<std::int64_t>(value) : static_cast<std::int64_t>(value);
+    }
+
+    const char* p_;
+    const char* end_;
+};
+
+template<typename T>
+void WriteArray(std::ostream& out, const std::vector<T>& data) {
+    std::uint64_t size = data.size();
+    out.write(reinterpret_cast<const char*>(&size), sizeof(size));
+    out.write(reinterpret_cast<const char*>(data.data()), sizeof(T) * size);
+}
+
+// Reads one of the binary formats from a mapped file. Every length comes
+// from the file, so it is checked against the bytes left before anything
+// is sized: a corrupt or truncated file fails instead of allocating.
+class BinaryReader {
+public:
+    BinaryReader(const char* begin, const char* end)
+        : p_(begin)
+        , end_(end)
+    {}
+
+    template<typename T>
+    bool read(T& value) {
+        if(left() < sizeof(T)) {
+            return false;
+        }
+        std::memcpy(&value, p_, sizeof(T));
+        p_ += sizeof(T);
+        return true;
+    }
+
+    // A 64-bit count, then that many T, as written by WriteArray
+    // Time - O(count)
+    template<typename T>
+    bool read_array(std::vector<T>& data) {
+        std::uint64_t size = 0;
+        if(!read(size) || size > left() / sizeof(T)) {
+            return false;
+        }
+        data.resize(size);
+        if(size == 0) {
+            // data() may be null and memcpy must not see it even for 0 bytes
+            return true;
+        }
+        std::memcpy(data.data(), p_, sizeof(T) * size);
+        p_ += sizeof(T) * size;
+        return true;
+    }
+
+    bool at_end() const {
+        return p_ == end_;
+    }
+
+private:
+    std::size_t left() const {
+        return static_cast<std::size_t>(end_ - p_);
+    }
+
+    const char* p_;
+    const char* end_;
+};
+
+// Offsets and targets of a loaded CSR over n vertices are safe to traverse:
+// n + 1 offsets from 0, non-decreasing, ending at the target count, and
+// every target a dense index
+// Time - O(N + E)
+bool ValidCsrArrays(const std::vector<int>& offsets, const std::vector<int>& targets, std::size_t n) {
+    if(offsets.size() != n + 1 || offsets[0] != 0 ||
+       static_cast<std::size_t>(offsets.back()) != targets.size()) {
+        return false;
+    }
+    if(std::adjacent_find(offsets.begin(), offsets.end(), [](int a, int b) { return a > b; }) != offsets.end()) {
+        return false;
+    }
+    return std::all_of(targets.begin(), targets.end(), [n](int v) {
+        return v >= 0 && static_cast<std::size_t>(v) < n;
+    });
+}
+
+// Binary CSR for repeat loads: magic, external ids, offsets, neighbours as
+// raw arrays. The graph is saved renumbered in external id order, so a
+// load is three reads with no parsing, degree counting or hashing.
+constexpr std::uint64_t kCsrMagic = 0x31525343'52414655ULL;
+
+// Time - O(N log N + E)
+// Memory - O(N + E)
+bool SaveCsrGraph(const CsrGraph& graph, const std::string& path) {
+    const int n = graph.vertex_count();
+    std::vector<std::pair<VertexId, int>> order(n);
+    for(int v = 0; v < n; ++v) {
+        order[v] = {graph.external(v), v};
+    }
+    std::sort(order.begin(), order.end());
+    std::vector<int> rank(n);
+    for(int i = 0; i < n; ++i) {
+        rank[order[i].second] = i;
+    }
+
+    std::vector<VertexId> ids(n);
+    std::vector<int> offsets(n + 1, 0);
+    std::vector<int> neighbors;
+    neighbors.reserve(graph.edge_count());
+    for(int i = 0; i < n; ++i) {
+        ids[i] = order[i].first;
+        for(int u : graph.next(order[i].second)) {
+            neighbors.push_back(rank[u]);
+        }
+        offsets[i + 1] = static_cast<int>(neighbors.size());
+    }
+
+    std::ofstream out(path, std::ios::binary);
+    out.write(reinterpret_cast<const char*>(&kCsrMagic), sizeof(kCsrMagic));
+    WriteArray(out, ids);
+    WriteArray(out, offsets);
+    WriteArray(out, neighbors);
+    return static_cast<bool>(out);
+}
+
+// Dense ids of the loaded graph follow external id order. The file is
+// mapped and checked in full, so a corrupt one fails here instead of
+// reading out of bounds in a later traversal.
+// Time - O(N + E)
+// Memory - O(N + E)
+bool LoadCsrGraph(const std::string& path, CsrGraph& graph) {
+    graph = CsrGraph{};
+    MappedFile file;
+    if(!file.open(path)) {
+        return false;
+    }
+    file.sequential();
+
+    BinaryReader in(file.data(), file.data() + file.size());
+    std::uint64_t magic = 0;
+    std::vector<VertexId> ids;
+    bool ok = in.read(magic) && magic == kCsrMagic &&
+              in.read_array(ids) && in.read_array(graph.offsets) && in.read_array(graph.neighbors) &&
+              in.at_end() && ValidCsrArrays(graph.offsets, graph.neighbors, ids.size()) &&
+              std::adjacent_find(ids.begin(), ids.end(), [](VertexId a, VertexId b) { return a >= b; }) == ids.end();
+    if(!ok) {
+        graph = CsrGraph{};
+        return false;
+    }
+    graph.ids.assign_sorted(std::move(ids));
+    return true;
+}
+
+// "a b" rows from a mapped text or CSV file, interned straight into the
+// CSR arrays with no Edge list in between
+// Time - O(file size + N + E)
+// Memory - O(N + E)
+bool LoadEdgeList(const std::string& path, CsrGraph& graph) {
+    MappedFile file;
+    if(!file.open(path)) {
+        return false;
+    }
+    file.sequential();
+
+    graph = CsrGraph{};
+    std::vector<int> ends;
+    EdgeListParser parser(file.data(), file.data() + file.size());
+    std::int64_t row[2];
+    while (parser.next(row, 2))
+    {
+        ends.push_back(graph.ids.intern(row[0]));
+        ends.push_back(graph.ids.intern(row[1]));
+    }
+    FillCsr(graph, ends);
+    return true;
+}
+
+// "a b w" rows, e.g. a road CSV of endpoints and travel times. Weights
+// must be non-negative, as Dijkstra and the CH build assume; a negative
+// weight fails the load and leaves `graph` empty.
+// Time - O(file size + N + E)
+// Memory - O(N + E)
+bool LoadWeightedEdgeList(const std::string& path, WeightedCsrGraph& graph, bool directed = false) {
+    MappedFile file;
+    if(!file.open(path)) {
+        return false;
+    }
+    file.sequential();
+
+    graph = WeightedCsrGraph{};
+    graph.directed = directed;
+    ArcList arcs;
+    EdgeListParser parser(file.data(), file.data() + file.size());
+    std::int64_t row[3];
+    while (parser.next(row, 3))
+    {
+        if(row[2] < 0) {
+            graph = WeightedCsrGraph{};
+            graph.directed = directed;
+            return false;
+        }
+        arcs.add(graph.ids.intern(row[0]), graph.ids.intern(row[1]), row[2], directed);
+    }
+    FillWeightedCsr(graph, arcs);
+    return true;
+}
+
+// Min-heap of dense vertex indices keyed by distance, D children per node.
+// pos_ maps every item to its slot, which is what makes decrease-key O(log N).
+// A 4-ary heap is half as deep as a binary one and its children share a
+// cache line.
+template<int D>
+class IndexedDaryHeap {
+public:
+    void resize(int n) {
+        if(static_cast<int>(pos_.size()) < n) {
+            pos_.resize(n, -1);
+        }
+    }
+
+    // O(size), leaves the capacity in place
+    void clear() {
+        for(const Entry& e : heap_) {
+            pos_[e.item] = -1;
+        }
+        heap_.clear();
+    }
+
+    bool empty() const {
+        return heap_.empty();
+    }
+
+    int top() const {
+        return heap_.front().item;
+    }
+
+    Weight top_key() const {
+        return heap_.front().key;
+    }
+
+    bool contains(int item) const {
+        return pos_[item] >= 0;
+    }
+
+    // Time - O(log N)
+    void push_or_decrease(int item, Weight key) {
+        int i = pos_[item];
+        if(i < 0) {
+            i = static_cast<int>(heap_.size());
+            heap_.push_back(Entry{key, item});
+        } else if(key >= heap_[i].key) {
+            return;
+        } else {
+            heap_[i].key = key;
+        }
+        sift_up(i);
+    }
+
+    // Time - O(D * log N)
+    int pop() {
+        int item = heap_.front().item;
+        pos_[item] = -1;
+        Entry last = heap_.back();
+        heap_.pop_back();
+        if(!heap_.empty()) {
+            heap_[0] = last;
+            pos_[last.item] = 0;
+            sift_down(0);
+        }
+        return item;
+    }
+
+private:
+    struct Entry {
+        Weight key;
+        int item;
+    };
+
+    void sift_up(int i) {
+        Entry e = heap_[i];
+        while (i > 0)
+        {
+            int parent = (i - 1) / D;
+            if(heap_[parent].key <= e.key) {
+                break;
+            }
+            place(i, heap_[parent]);
+            i = parent;
+        }
+        place(i, e);
+    }
+
+    void sift_down(int i) {
+        Entry e = heap_[i];
+        const int size = static_cast<int>(heap_.size());
+        while (true)
+        {
+            int first = i * D + 1;
+            if(first >= size) {
+                break;
+            }
+            int best = first;
+            int last = std::min(first + D, size);
+            for(int c = first + 1; c < last; ++c) {
+                if(heap_[c].key < heap_[best].key) {
+                    best = c;
+                }
+            }
+            if(heap_[best].key >= e.key) {
+                break;
+            }
+            place(i, heap_[best]);
+            i = best;
+        }
+        place(i, e);
+    }
+
+    void place(int i, const Entry& e) {
+        heap_[i] = e;
+        pos_[e.item] = i;
+    }
+
+    std::vector<Entry> heap_;
+    std::vector<int> pos_;
+};
+
+// Point-to-point shortest paths on one graph. Distances, parents and the heap
+// live in the engine and are reset per query with an epoch, so a warmed-up
+// engine answers queries without allocating.
+class DijkstraEngine {
+public:
+    struct Route {
+        bool found() const { return cost != kInfinity; }
+
+        Weight cost{kInfinity};
+        std::vector<VertexId> path;
+    };
+
+    explicit DijkstraEngine(const WeightedCsrGraph& graph)
+        : graph_(graph)
+    {
+        forward_.prepare(graph.vertex_count());
+        backward_.prepare(graph.vertex_count());
+    }
+
+    // Stops as soon as the target is settled.
+    // Time - O((N + E) * log N)
+    // Memory - O(1) beyond the engine
+    Weight distance(int source, int target) {
+        meeting_ = -1;
+        forward_.reset();
+        backward_.reset();
+        if(!graph_.contains(source) || !graph_.contains(target)) {
+            return kInfinity;
+        }
+
+        forward_.relax(source, 0, -1);
+        while (!forward_.heap.empty())
+        {
+            int curr = forward_.heap.pop();
+            if(curr == target) {
+                meeting_ = target;
+                return forward_.get(target);
+            }
+            forward_.expand(curr, graph_.forward);
+        }
+        return kInfinity;
+    }
+
+    // Alternates a forward search from the source and a backward search from
+    // the target, and stops once top_f + top_b can no longer beat the best
+    // path through a vertex reached by both.
+    Weight distance_bidirectional(int source, int target) {
+        meeting_ = -1;
+        forward_.reset();
+        backward_.reset();
+        if(!graph_.contains(source) || !graph_.contains(target)) {
+            return kInfinity;
+        }
+
+        Weight best = kInfinity;
+        forward_.relax(source, 0, -1);
+        backward_.relax(target, 0, -1);
+        if(source == target) {
+            meeting_ = source;
+            return 0;
+        }
+
+        while (!forward_.heap.empty() && !backward_.heap.empty())
+        {
+            if(best != kInfinity && forward_.heap.top_key() + backward_.heap.top_key() >= best) {
+                break;
+            }
+
+            bool go_forward = forward_.heap.top_key() <= backward_.heap.top_key();
+            SearchSide& side = go_forward ? forward_ : backward_;
+            SearchSide& other = go_forward ? backward_ : forward_;
+            const WeightedAdjacency& adj = go_forward ? graph_.forward : graph_.backward();
+
+            int curr = side.heap.pop();
+            for(int i = adj.begin(curr); i < adj.end(curr); ++i) {
+                int n = adj.targets[i];
+                Weight d = side.get(curr) + adj.weights[i];
+                side.relax(n, d, curr);
+                Weight through = other.get(n);
+                if(through != kInfinity && side.get(n) + through < best) {
+                    best = side.get(n) + through;
+                    meeting_ = n;
+                }
+            }
+        }
+        return best;
+    }
+
+    // External ids in travel order plus total cost
+    Route route(VertexId from, VertexId to, bool bidirectional = false) {
+        Route ans;
+        int source = graph_.dense(from);
+        int target = graph_.dense(to);
+        ans.cost = bidirectional ? distance_bidirectional(source, target) : distance(source, target);
+        if(!ans.found()) {
+            return ans;
+        }
+
+        for(int v = meeting_; v >= 0; v = forward_.parent[v]) {
+            ans.path.push_back(graph_.external(v));
+        }
+        std::reverse(ans.path.begin(), ans.path.end());
+        if(bidirectional && meeting_ != target) {
+            for(int v = backward_.parent[meeting_]; v >= 0; v = backward_.parent[v]) {
+                ans.path.push_back(graph_.external(v));
+            }
+        }
+        return ans;
+    }
+
+private:
+    struct SearchSide {
+        void prepare(int n) {
+            dist.resize(n);
+            parent.resize(n);
+            reached.resize(n);
+            heap.resize(n);
+        }
+
+        void reset() {
+            reached.reset();
+            heap.clear();
+        }
+
+        Weight get(int v) const {
+            return reached.test(v) ? dist[v] : kInfinity;
+        }
+
+        void relax(int v, Weight d, int from) {
+            if(d >= get(v)) {
+                return;
+            }
+            reached.set(v);
+            dist[v] = d;
+            parent[v] = from;
+            heap.push_or_decrease(v, d);
+        }
+
+        void expand(int v, const WeightedAdjacency& adj) {
+            Weight base = dist[v];
+            for(int i = adj.begin(v); i < adj.end(v); ++i) {
+                relax(adj.targets[i], base + adj.weights[i], v);
+            }
+        }
+
+        std::vector<Weight> dist;
+        std::vector<int> parent;
+        EpochVisited reached;
+        IndexedDaryHeap<4> heap;
+    };
+
+    const WeightedCsrGraph& graph_;
+    SearchSide forward_;
+    SearchSide backward_;
+    int meeting_{-1};
+};
+
+// Contraction Hierarchies.
+// Vertices are contracted one by one in order of importance. Contracting v
+// removes it and adds a shortcut u -> x for every pair of remaining
+// neighbors whose only shortest path runs through v. A query then only
+// searches upward in rank from both ends, which explores a tiny part of
+// the graph.
+struct ContractionHierarchy {
+    // CSR arcs; middle is the contracted vertex a shortcut skips, -1 for a road
+    struct Arcs {
+        int begin(int v) const { return offsets[v]; }
+        int end(int v) const { return offsets[v + 1]; }
+
+        std::vector<int> offsets;
+        std::vector<int> targets;
+        std::vector<Weight> weights;
+        std::vector<int> middles;
+    };
+
+    int vertex_count() const {
+        return static_cast<int>(rank.size());
+    }
+
+    int dense(VertexId id) const {
+        return ids.find(id);
+    }
+
+    VertexId external(int v) const {
+        return ids.external(v);
+    }
+
+    // u -> x with rank[x] > rank[u], stored at u
+    Arcs up;
+    // u -> x with rank[u] > rank[x], stored reversed at x
+    Arcs down;
+    std::vector<int> rank;
+    IdInterner ids;
+};
+
+// Time - O(N * witness search), minutes for continental road graphs
+// Memory - O(N + E + shortcuts)
+class ChBuilder {
+public:
+    explicit ChBuilder(const WeightedCsrGraph& graph)
+        : n_(graph.vertex_count())
+        , out_(n_)
+        , in_(n_)
+        , contracted_(n_, false)
+        , deleted_neighbors_(n_, 0)
+        , dist_(n_)
+    {
+        for(int v = 0; v < n_; ++v) {
+            for(int i = graph.forward.begin(v); i < graph.forward.end(v); ++i) {
+                add_arc(v, graph.forward.targets[i], graph.forward.weights[i], -1);
+            }
+        }
+        reached_.resize(n_);
+        heap_.resize(n_);
+    }
+
+    ContractionHierarchy build(const WeightedCsrGraph& graph) {
+        ContractionHierarchy ch;
+        ch.rank.assign(n_, -1);
+        for(int v = 0; v < n_; ++v) {
+            ch.ids.intern(graph.external(v));
+        }
+
+        // Lazy updates: a popped vertex is re-evaluated and pushed back
+        // if its priority got worse than the next candidate
+        using Item = std::pair<int, int>;
+        std::priority_queue<Item, std::vector<Item>, std::greater<Item>> order;
+        for(int v = 0; v < n_; ++v) {
+            order.push(Item{priority(v), v});
+        }
+
+        int next_rank = 0;
+        while (!order.empty())
+        {
+            int v = order.top().second;
+            order.pop();
+            if(contracted_[v]) {
+                continue;
+            }
+
+            int p = priority(v);
+            if(!order.empty() && p > order.top().first) {
+                order.push(Item{p, v});
+                continue;
+            }
+
+            contract(v, false);
+            contracted_[v] = true;
+            ch.rank[v] = next_rank++;
+            for(const Arc& a : out_[v]) {
+                ++deleted_neighbors_[a.to];
+            }
+            for(const Arc& a : in_[v]) {
+                ++deleted_neighbors_[a.to];
+            }
+        }
+
+        split(ch);
+        return ch;
+    }
+
+private:
+    struct Arc {
+        int to;
+        Weight w;
+        int middle;
+    };
+
+    struct Shortcut {
+        int from;
+        int to;
+        Weight w;
+    };
+
+    static constexpr int kSettleLimit = 500;
+
+    void add_arc(int u, int x, Weight w, int middle) {
+        for(Arc& a : out_[u]) {
+            if(a.to == x) {
+                if(w < a.w) {
+                    a.w = w;
+                    a.middle = middle;
+                    for(Arc& b : in_[x]) {
+                        if(b.to == u) {
+                            b.w = w;
+                            b.middle = middle;
+                        }
+                    }
+                }
+                return;
+            }
+        }
+        out_[u].push_back(Arc{x, w, middle});
+        in_[x].push_back(Arc{u, w, middle});
+    }
+
+    // Edge difference plus deleted neighbors, which spreads contraction
+    // evenly over the graph
+    int priority(int v) {
+        int degree = 0;
+        for(const Arc& a : out_[v]) {
+            degree += !contracted_[a.to];
+        }
+        for(const Arc& a : in_[v]) {
+            degree += !contracted_[a.to];
+        }
+        return contract(v, true) - degree + deleted_neighbors_[v];
+    }
+
+    // Returns the number of shortcuts contracting v needs; adds them unless simulating
+    int contract(int v, bool simulate) {
+        int shortcuts = 0;
+        for(const Arc& in : in_[v]) {
+            int u = in.to;
+            if(contracted_[u] || u == v) {
+                continue;
+            }
+
+            Weight limit = 0;
+            for(const Arc& out : out_[v]) {
+                if(!contracted_[out.to] && out.to != u) {
+                    limit = std::max(limit, in.w + out.w);
+                }
+            }
+            witness_search(u, v, limit);
+
+            for(const Arc& out : out_[v]) {
+                int x = out.to;
+                if(contracted_[x] || x == u || x == v) {
+                    continue;
+                }
+                Weight via = in.w + out.w;
+                Weight witness = reached_.test(x) ? dist_[x] : kInfinity;
+                if(witness <= via) {
+                    continue;
+                }
+                ++shortcuts;
+                if(!simulate) {
+                    shortcut_buffer_.push_back(Shortcut{u, x, via});
+                }
+            }
+        }
+
+        if(!simulate) {
+            for(const Shortcut& s : shortcut_buffer_) {
+                add_arc(s.from, s.to, s.w, v);
+            }
+            shortcut_buffer_.clear();
+        }
+        return shortcuts;
+    }
+
+    // Bounded Dijkstra from u in the remaining graph, skipping v
+    void witness_search(int u, int v, Weight limit) {
+        reached_.reset();
+        heap_.clear();
+        reached_.set(u);
+        dist_[u] = 0;
+        heap_.push_or_decrease(u, 0);
+
+        int settled = 0;
+        while (!heap_.empty() && settled < kSettleLimit)
+        {
+            if(heap_.top_key() > limit) {
+                break;
+            }
+            int curr = heap_.pop();
+            ++settled;
+            for(const Arc& a : out_[curr]) {
+                if(a.to == v || contracted_[a.to]) {
+                    continue;
+                }
+                Weight d = dist_[curr] + a.w;
+                if(!reached_.test(a.to) || d < dist_[a.to]) {
+                    reached_.set(a.to);
+                    dist_[a.to] = d;
+                    heap_.push_or_decrease(a.to, d);
+                }
+            }
+        }
+    }
+
+    // Splits every arc into the upward or downward CSR by rank
+    void split(ContractionHierarchy& ch) {
+        std::vector<std::vector<Arc>> up(n_);
+        std::vector<std::vector<Arc>> down(n_);
+        for(int u = 0; u < n_; ++u) {
+            for(const Arc& a : out_[u]) {
+                if(ch.rank[a.to] > ch.rank[u]) {
+                    up[u].push_back(a);
+                } else {
+                    down[a.to].push_back(Arc{u, a.w, a.middle});
+                }
+            }
+        }
+        flatten(up, ch.up);
+        flatten(down, ch.down);
+    }
+
+    static void flatten(const std::vector<std::vector<Arc>>& lists, ContractionHierarchy::Arcs& arcs) {
+        arcs.offsets.assign(1, 0);
+        for(const auto& list : lists) {
+            for(const Arc& a : list) {
+                arcs.targets.push_back(a.to);
+                arcs.weights.push_back(a.w);
+                arcs.middles.push_back(a.middle);
+            }
+            arcs.offsets.push_back(static_cast<int>(arcs.targets.size()));
+        }
+    }
+
+    int n_;
+    std::vector<std::vector<Arc>> out_;
+    std::vector<std::vector<Arc>> in_;
+    std::vector<bool> contracted_;
+    std::vector<int> deleted_neighbors_;
+    std::vector<Shortcut> shortcut_buffer_;
+
+    std::vector<Weight> dist_;
+    EpochVisited reached_;
+    IndexedDaryHeap<4> heap_;
+};
+
+ContractionHierarchy BuildContractionHierarchy(const WeightedCsrGraph& graph) {
+    ChBuilder builder(graph);
+    return builder.build(graph);
+}
+
+// Binary layout: magic, N, ids, ranks, then up and down arcs as raw arrays
+constexpr std::uint64_t kChMagic = 0x31484355'52414655ULL;
+
+bool SaveContractionHierarchy(const ContractionHierarchy& ch, const std::string& path) {
+    std::ofstream out(path, std::ios::binary);
+    std::vector<VertexId> ids(ch.vertex_count());
+    for(int v = 0; v < ch.vertex_count(); ++v) {
+        ids[v] = ch.external(v);
+    }
+
+    out.write(reinterpret_cast<const char*>(&kChMagic), sizeof(kChMagic));
+    WriteArray(out, ids);
+    WriteArray(out, ch.rank);
+    for(const ContractionHierarchy::Arcs* arcs : {&ch.up, &ch.down}) {
+        WriteArray(out, arcs->offsets);
+        WriteArray(out, arcs->targets);
+        WriteArray(out, arcs->weights);
+        WriteArray(out, arcs->middles);
+    }
+    return static_cast<bool>(out);
+}
+
+// Arcs of a loaded hierarchy over n vertices: valid CSR arrays, one weight
+// and one middle per target, weights non-negative, middles -1 or a vertex
+// Time - O(N + E)
+bool ValidChArcs(const ContractionHierarchy::Arcs& arcs, std::size_t n) {
+    if(!ValidCsrArrays(arcs.offsets, arcs.targets, n) ||
+       arcs.weights.size() != arcs.targets.size() || arcs.middles.size() != arcs.targets.size()) {
+        return false;
+    }
+    return std::all_of(arcs.weights.begin(), arcs.weights.end(), [](Weight w) { return w >= 0; }) &&
+           std::all_of(arcs.middles.begin(), arcs.middles.end(), [n](int m) {
+               return m >= -1 && (m < 0 || static_cast<std::size_t>(m) < n);
+           });
+}
+
+// The file is mapped and checked in full: on any failure ch is left empty
+// Time - O(N + E)
+// Memory - O(N + E)
+bool LoadContractionHierarchy(const std::string& path, ContractionHierarchy& ch) {
+    ch = ContractionHierarchy{};
+    MappedFile file;
+    if(!file.open(path)) {
+        return false;
+    }
+    BinaryReader in(file.data(), file.data() + file.size());
+    std::uint64_t magic = 0;
+    std::vector<VertexId> ids;
+    bool ok = in.read(magic) && magic == kChMagic && in.read_array(ids) && in.read_array(ch.rank);
+    for(ContractionHierarchy::Arcs* arcs : {&ch.up, &ch.down}) {
+        ok = ok && in.read_array(arcs->offsets) && in.read_array(arcs->targets)
+                && in.read_array(arcs->weights) && in.read_array(arcs->middles);
+    }
+    const std::size_t n = ids.size();
+    ok = ok && in.at_end() && ch.rank.size() == n && ValidChArcs(ch.up, n) && ValidChArcs(ch.down, n);
+
+    // Ranks are a permutation of 0..N-1
+    std::vector<bool> ranked(n, false);
+    for(std::size_t v = 0; ok && v < n; ++v) {
+        int r = ch.rank[v];
+        ok = r >= 0 && static_cast<std::size_t>(r) < n && !ranked[r];
+        if(ok) {
+            ranked[r] = true;
+        }
+    }
+
+    // A repeated id would collapse two vertices and put ids out of step with rank
+    for(std::size_t v = 0; ok && v < n; ++v) {
+        ok = ch.ids.intern(ids[v]) == static_cast<int>(v);
+    }
+    if(!ok) {
+        ch = ContractionHierarchy{};
+        return false;
+    }
+    return true;
+}
+
+// Bidirectional Dijkstra restricted to upward arcs on both sides. Each side
+// stops once its smallest key reaches the best meeting distance.
+class ChQueryEngine {
+public:
+    explicit ChQueryEngine(const ContractionHierarchy& ch)
+        : ch_(ch)
+    {
+        forward_.prepare(ch.vertex_count());
+        backward_.prepare(ch.vertex_count());
+    }
+
+    Weight distance(int source, int target) {
+        int n = ch_.vertex_count();
+        forward_.reset();
+        backward_.reset();
+        meeting_ = -1;
+        if(source < 0 || source >= n || target < 0 || target >= n) {
+            return kInfinity;
+        }
+
+        Weight best = kInfinity;
+        forward_.relax(source, 0, -1);
+        backward_.relax(target, 0, -1);
+        while (!forward_.heap.empty() || !backward_.heap.empty())
+        {
+            for(bool go_forward : {true, false}) {
+                Side& side = go_forward ? forward_ : backward_;
+                Side& other = go_forward ? backward_ : forward_;
+                if(side.heap.empty()) {
+                    continue;
+                }
+                if(side.heap.top_key() >= best) {
+                    side.heap.clear();
+                    continue;
+                }
+
+                int curr = side.heap.pop();
+                Weight through = other.get(curr);
+                if(through != kInfinity && side.get(curr) + through < best) {
+                    best = side.get(curr) + through;
+                    meeting_ = curr;
+                }
+
+                // Stall-on-demand: a higher vertex already reaches curr more
+                // cheaply, so nothing found through curr can be shortest
+                const ContractionHierarchy::Arcs& opposite = go_forward ? ch_.down : ch_.up;
+                bool stalled = false;
+                for(int i = opposite.begin(curr); i < opposite.end(curr) && !stalled; ++i) {
+                    Weight higher = side.get(opposite.targets[i]);
+                    stalled = higher != kInfinity && higher + opposite.weights[i] < side.get(curr);
+                }
+                if(stalled) {
+                    continue;
+                }
+
+                const ContractionHierarchy::Arcs& arcs = go_forward ? ch_.up : ch_.down;
+                for(int i = arcs.begin(curr); i < arcs.end(curr); ++i) {
+                    side.relax(arcs.targets[i], side.get(curr) + arcs.weights[i], curr);
+                }
+            }
+        }
+        return best;
+    }
+
+    // Shortcuts are unpacked back into original roads
+    DijkstraEngine::Route route(VertexId from, VertexId to) {
+        DijkstraEngine::Route ans;
+        int source = ch_.dense(from);
+        int target = ch_.dense(to);
+        ans.cost = distance(source, target);
+        if(!ans.found()) {
+            return ans;
+        }
+
+        std::vector<int> up_path;
+        for(int v = meeting_; v >= 0; v = forward_.parent[v]) {
+            up_path.push_back(v);
+        }
+        std::reverse(up_path.begin(), up_path.end());
+        for(int v = backward_.parent[meeting_]; v >= 0; v = backward_.parent[v]) {
+            up_path.push_back(v);
+        }
+
+        ans.path.push_back(ch_.external(up_path[0]));
+        for(std::size_t i = 0; i + 1 < up_path.size(); ++i) {
+            unpack(up_path[i], up_path[i + 1], ans.path);
+        }
+        return ans;
+    }
+
+private:
+    struct Side {
+        void prepare(int n) {
+            dist.resize(n);
+            parent.resize(n);
+            reached.resize(n);
+            heap.resize(n);
+        }
+
+        void reset() {
+            reached.reset();
+            heap.clear();
+        }
+
+        Weight get(int v) const {
+            return reached.test(v) ? dist[v] : kInfinity;
+        }
+
+        void relax(int v, Weight d, int from) {
+            if(d >= get(v)) {
+                return;
+            }
+            reached.set(v);
+            dist[v] = d;
+            parent[v] = from;
+            heap.push_or_decrease(v, d);
+        }
+
+        std::vector<Weight> dist;
+        std::vector<int> parent;
+        EpochVisited reached;
+        IndexedDaryHeap<4> heap;
+    };
+
+    // Cheapest middle of the stored arc u -> x, -2 if there is none
+    int middle(int u, int x) const {
+        const ContractionHierarchy::Arcs& arcs = ch_.rank[x] > ch_.rank[u] ? ch_.up : ch_.down;
+        int from = ch_.rank[x] > ch_.rank[u] ? u : x;
+        int to = ch_.rank[x] > ch_.rank[u] ? x : u;
+        int ans = -2;
+        Weight best = kInfinity;
+        for(int i = arcs.begin(from); i < arcs.end(from); ++i) {
+            if(arcs.targets[i] == to && arcs.weights[i] < best) {
+                best = arcs.weights[i];
+                ans = arcs.middles[i];
+            }
+        }
+        return ans;
+    }
+
+    // Appends the original vertices after u on the arc u -> x
+    void unpack(int u, int x, std::vector<VertexId>& path) const {
+        int m = middle(u, x);
+        if(m < 0) {
+            path.push_back(ch_.external(x));
+            return;
+        }
+        unpack(u, m, path);
+        unpack(m, x, path);
+    }
+
+    const ContractionHierarchy& ch_;
+    Side forward_;
+    Side backward_;
+    int meeting_{-1};
+};
+
+// Define UFAR_NO_MAIN to include this file from a benchmark or another driver
+#ifndef UFAR_NO_MAIN
+int main() {
+    SimpleGraph edges {
+        Edge{1, 2},
+        Edge{1, 3},
+        Edge{2, 3},
+        Edge{3, 4},
+        Edge{3, 5},
+        // Edge{3, 7},
+        Edge{4, 5},
+        Edge{6, 7}
+    };
+
+    auto graph = CreateGraph(edges);
+    dfs(1, graph);
+
+    std::cout << "-----------------------" << std::endl;
+
+    // Every query has its own visited set now, so dfs no longer breaks bfs
+    std::cout << bfs(1, 5, graph, [](VertexId) {}) << std::endl;
+
+    auto csr = CreateCsrGraph(edges);
+    dfs(1, csr);
+
+    std::cout << "-----------------------" << std::endl;
+
+    dfs_iterative(1, csr);
+
+    std::cout << "-----------------------" << std::endl;
+
+    // Reverse post-order over a path long enough to overflow a recursive dfs
+    SimpleGraph path;
+    for(VertexId v = 0; v + 1 < 1000000; ++v) {
+        path.push_back(Edge{v, v + 1});
+    }
+    auto path_csr = CreateCsrGraph(path);
+    DfsContext ctx;
+    int discovered = 0;
+    int last_finished = -1;
+    dfs_iterative(path_csr.dense(0), path_csr, ctx,
+                  [&](int) { ++discovered; },
+                  [&](int v) { last_finished = v; });
+    std::cout << discovered << " " << path_csr.external(last_finished) << std::endl;
+
+    dfs_iterative(1, csr, ctx);
+
+    // No-op visitor: traversal cost only, as a benchmark would measure it
+    dfs(1, csr, NullVisitor{});
+    std::cout << bfs(0, 999999, path_csr, NullVisitor{}) << std::endl;
+
+    std::cout << "-----------------------" << std::endl;
+
+    std::cout << bfs(1, 5, csr) << std::endl;
+
+    // Concurrent queries over one shared graph, each on a pooled context
+    std::vector<int> hops(4, 0);
+    RunParallel(4, [&](int t) {
+        for(int i = 0; i < 1000; ++i) {
+            hops[t] += bfs(1, 5, csr, NullVisitor{});
+        }
+    });
+    std::cout << hops[0] + hops[1] + hops[2] + hops[3] << std::endl;
+
+    std::cout << "-----------------------" << std::endl;
+
+    SimpleGraph sparse {
+        Edge{9000000000001, 42},
+        Edge{42, -7},
+        Edge{-7, 9000000000001},
+        Edge{-7, 123456789012}
+    };
+
+    auto sparse_csr = CreateCsrGraph(sparse);
+    dfs(9000000000001, sparse_csr);
+    std::cout << bfs(9000000000001, 123456789012, sparse_csr) << std::endl;
+
+    std::cout << "-----------------------" << std::endl;
+
+    BfsStats level_stats;
+    auto levels = parallel_bfs(1, csr, 4, &level_stats);
+    for(int v = 0; v < csr.vertex_count(); ++v) {
+        std::cout << csr.external(v) << ":" << levels[v] << " ";
+    }
+    std::cout << std::endl;
+
+    BfsContext bfs_ctx;
+    auto serial_levels = bfs_levels(1, csr, bfs_ctx);
+    std::cout << (serial_levels == levels) << std::endl;
+#if defined(UFAR_STATS)
+    level_stats.snapshot("parallel_bfs").write_json(std::cout);
+    std::cout << std::endl;
+    bfs_ctx.stats_snapshot().write_json(std::cout);
+    std::cout << std::endl;
+#endif
+
+    // {6, 7} is its own component; 7 is nearer to seed 6 than to seed 1
+    auto components = connected_components(csr, 4);
+    std::cout << components.count << " " << components.connected(csr.dense(1), csr.dense(5)) << " "
+              << components.connected(csr.dense(1), csr.dense(7)) << std::endl;
+    auto nearest = multi_source_bfs({1, 6}, csr, bfs_ctx);
+    for(VertexId v : {5, 7}) {
+        std::cout << v << ":" << nearest.distance[csr.dense(v)] << "/" << nearest.seed[csr.dense(v)] << " ";
+    }
+    std::cout << std::endl;
+
+    // A 30 x 30 grid whose cells arrive scrambled, relabelled for locality.
+    // External ids and answers stay the same, the bandwidth drops.
+    SimpleGraph grid;
+    for(int k = 0; k < 900; ++k) {
+        int cell = k * 7 % 900;
+        if(cell % 30 != 29) {
+            grid.push_back(Edge{cell, cell + 1});
+        }
+        if(cell < 870) {
+            grid.push_back(Edge{cell, cell + 30});
+        }
+    }
+    auto grid_csr = CreateCsrGraph(grid);
+    auto rcm = ReorderCsrGraph(grid_csr, rcm_order(grid_csr));
+    std::cout << bandwidth(grid_csr) << " " << bandwidth(rcm) << " "
+              << bfs(0, 899, grid_csr, NullVisitor{}) << " " << bfs(0, 899, rcm, NullVisitor{}) << std::endl;
+
+    // Same path, built by 4 threads; ids come out sorted by external id
+    auto parallel_path = CreateCsrGraphParallel(path, true, 4);
+    std::cout << parallel_path.vertex_count() << " " << parallel_path.edge_count() << " "
+              << parallel_path.external(parallel_path.next(parallel_path.dense(1)).begin()[1]) << std::endl;
+
+    std::cout << "-----------------------" << std::endl;
+
+    WeightedSimpleGraph roads {
+        WeightedEdge{1, 2, 7},
+        WeightedEdge{1, 3, 9},
+        WeightedEdge{1, 6, 14},
+        WeightedEdge{2, 3, 10},
+        WeightedEdge{2, 4, 15},
+        WeightedEdge{3, 4, 11},
+        WeightedEdge{3, 6, 2},
+        WeightedEdge{4, 5, 6},
+        WeightedEdge{5, 6, 9},
+        WeightedEdge{7, 8, 1}
+    };
+
+    auto city = CreateWeightedCsrGraph(roads);
+    DijkstraEngine engine(city);
+    for(bool bidirectional : {false, true}) {
+        auto r = engine.route(1, 5, bidirectional);
+        std::cout << r.cost << ":";
+        for(VertexId v : r.path) {
+            std::cout << " " << v;
+        }
+        std::cout << std::endl;
+    }
+    std::cout << engine.route(1, 7).found() << std::endl;
+
+    // Demo files go to the temp directory and are removed afterwards
+    const std::filesystem::path tmp = std::filesystem::temp_directory_path();
+    const std::string ch_path = (tmp / "ufar_city.ch").string();
+
+    auto ch = BuildContractionHierarchy(city);
+    SaveContractionHierarchy(ch, ch_path);
+    ContractionHierarchy loaded;
+    if(LoadContractionHierarchy(ch_path, loaded)) {
+        ChQueryEngine ch_engine(loaded);
+        auto r = ch_engine.route(1, 5);
+        std::cout << r.cost << ":";
+        for(VertexId v : r.path) {
+            std::cout << " " << v;
+        }
+        std::cout << std::endl;
+    }
+    std::filesystem::remove(ch_path);
+
+    std::cout << "-----------------------" << std::endl;
+
+    // The same roads as a CSV file, then the unweighted graph in binary
+    const std::string csv_path = (tmp / "ufar_roads.csv").string();
+    const std::string csr_path = (tmp / "ufar_roads.csr").string();
+    {
+        std::ofstream csv(csv_path);
+        csv << "from,to,minutes\n";
+        for(const WeightedEdge& road : roads) {
+            csv << road.a << "," << road.b << "," << road.w << "\n";
+        }
+    }
+    WeightedCsrGraph from_csv;
+    if(LoadWeightedEdgeList(csv_path, from_csv)) {
+        DijkstraEngine csv_engine(from_csv);
+        std::cout << csv_engine.route(1, 5).cost << std::endl;
+    }
+    CsrGraph road_map;
+    if(LoadEdgeList(csv_path, road_map) && SaveCsrGraph(road_map, csr_path) && LoadCsrGraph(csr_path, road_map)) {
+        std::cout << road_map.vertex_count() << " " << road_map.edge_count() << std::endl;
+    }
+    std::filesystem::remove(csv_path);
+    std::filesystem::remove(csr_path);
     return 0;
 }
+#endif
@@ -1,17 +1,162 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <functional>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
 #include <unordered_set>
 #include <vector>
 
-// int
+#if __cplusplus >= 202002L
+#include <span>
+#endif
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "arena.h"
+#include "stats.h"
+
+// Hash policies return a well-mixed 64-bit value. Tables have power-of-two
+// capacity and take the bits they need with a mask, so low bits must be as
+// good as high ones.
+
+// Fibonacci hashing: multiply by 2^64 / phi and use the top bits of the
+// product, which depend on every key bit and spread arithmetic progressions
+// almost perfectly. The tables mask the low bits, so the product is
+// byte-swapped to bring its top bits down: mask bits 0-15 are product bits
+// 48-63, and wider masks take the next bytes down. Folding the high half
+// into the low one instead (h ^ h >> 32) leaves the low bits mostly driven
+// by the key's low bits, and sequential or strided keys cluster. One
+// multiply and one bswap; a full splitmix64 finalizer mixes as well but
+// made BM_Find about half again as slow. Negative keys are just bit patterns.
+struct FibonacciHash {
+    template<typename Key>
+    std::uint64_t operator()(Key key) const {
+        static_assert(std::is_integral<Key>::value || std::is_enum<Key>::value, "integral keys only");
+        return __builtin_bswap64(static_cast<std::uint64_t>(key) * 0x9E3779B97F4A7C15ULL);
+    }
+};
+
+// wyhash-style hash for byte strings: 16 bytes per step through a 64x64->128
+// multiply folded with xor. A compact variant, not bit-compatible with wyhash.
+struct WyHash {
+    static std::uint64_t mum(std::uint64_t a, std::uint64_t b) {
+        __uint128_t r = static_cast<__uint128_t>(a) * b;
+        return static_cast<std::uint64_t>(r) ^ static_cast<std::uint64_t>(r >> 64);
+    }
+
+    static std::uint64_t read8(const char* p) {
+        std::uint64_t v;
+        std::memcpy(&v, p, 8);
+        return v;
+    }
+
+    static std::uint64_t read_tail(const char* p, std::size_t n) {
+        std::uint64_t v = 0;
+        std::memcpy(&v, p, n);
+        return v;
+    }
+
+    std::uint64_t operator()(std::string_view key) const {
+        constexpr std::uint64_t s0 = 0xA0761D6478BD642FULL;
+        constexpr std::uint64_t s1 = 0xE7037ED1A0B428DBULL;
+        constexpr std::uint64_t s2 = 0x8EBC6AF09C88C6E3ULL;
+
+        const char* p = key.data();
+        std::size_t n = key.size();
+        std::uint64_t seed = s0 ^ n;
+        while (n > 16)
+        {
+            seed = mum(read8(p) ^ s1, read8(p + 8) ^ seed);
+            p += 16;
+            n -= 16;
+        }
+
+        std::uint64_t a = n > 8 ? read8(p) : read_tail(p, n);
+        std::uint64_t b = n > 8 ? read_tail(p + 8, n - 8) : 0;
+        return mum(s1 ^ key.size(), mum(a ^ s1, b ^ seed) ^ s2);
+    }
+};
+
+// Integers use FibonacciHash, strings WyHash, anything else std::hash with
+// a final mix because std::hash<int> is the identity on common libraries.
+template<typename Key, typename = void>
+struct DefaultHash {
+    std::uint64_t operator()(const Key& key) const {
+        return FibonacciHash{}(static_cast<std::uint64_t>(std::hash<Key>{}(key)));
+    }
+};
+
+template<typename Key>
+struct DefaultHash<Key, std::enable_if_t<std::is_integral<Key>::value>> : FibonacciHash {};
+
+template<typename Key>
+struct DefaultHash<Key, std::enable_if_t<std::is_convertible<const Key&, std::string_view>::value>> : WyHash {};
+
+// Keys per group in the batched APIs: enough independent cache misses in
+// flight to hide memory latency, few enough that prefetched lines stay in L1
+constexpr std::size_t kBatch = 16;
+
+// Smallest power of two >= n, at least `floor`
+inline std::size_t round_up_pow2(std::size_t n, std::size_t floor) {
+    std::size_t capacity = floor;
+    while (capacity < n) {
+        capacity *= 2;
+    }
+    return capacity;
+}
+
+template<typename Key, typename Hash = DefaultHash<Key>>
 class HashTable {
 private:
     struct ListNode {
-        int data;
+        Key data;
         ListNode* next;
     };
 
-    int hash(int data, int K) {
-        return data % K;
+    // Old buckets moved per operation while a rehash is in progress.
+    // Growth starts at load 0.5 with K old buckets and the next growth is
+    // K / 2 inserts away, so 4 per insert always finishes in time.
+    static constexpr int kMigrateBuckets = 4;
+
+    // Grow above 1/2, shrink below 1/8. A shrunk table is sized for 1/4,
+    // well clear of both limits, so alternating insert/erase cannot thrash.
+    static constexpr int kShrinkBelow = 8;
+
+    // K is a power of two, so this is a mask instead of a division
+    std::size_t hash(const Key& data, std::size_t K) const {
+        return static_cast<std::size_t>(hash_(data)) & (K - 1);
+    }
+
+    // Keys that own memory are destroyed here; the pool itself never runs
+    // destructors. Mid-rehash, only old_ buckets not yet migrated own nodes.
+    void destroy_nodes() {
+        if constexpr (!std::is_trivially_destructible<ListNode>::value) {
+            auto destroy_chain = [](ListNode* head) {
+                while (head)
+                {
+                    ListNode* next = head->next;
+                    head->~ListNode();
+                    head = next;
+                }
+            };
+            for(std::size_t i = rehashing() ? migrate_pos_ : 0; i < old_.size(); ++i) {
+                destroy_chain(old_[i]);
+            }
+            for(ListNode* head : table_) {
+                destroy_chain(head);
+            }
+        }
     }
 
     double get_balance_factor() {
@@ -19,78 +164,235 @@ private:
         return static_cast<double>(size_) / K;
     }
 
-    // Time - O(K + N)
-    // Memory - O(K + N)
-    void resize() {
-        std::vector<ListNode*> new_table(table_.size() * 2, nullptr);
-        for (ListNode* head : table_)
+    bool rehashing() const {
+        return !old_.empty();
+    }
+
+    // Allocates the new array; nodes stay in old_ until migrated
+    // Time - O(K)
+    // Memory - O(K)
+    void start_rehash(std::size_t buckets) {
+        UFAR_STAT(++stats_.rehashes; StatsTimer timer(stats_.rehash_ns);)
+        old_ = std::move(table_);
+        table_.assign(buckets, nullptr);
+        migrate_pos_ = 0;
+    }
+
+    // Relinks the nodes of up to `buckets` old buckets into table_,
+    // no allocation and no change to size_. An empty bucket only costs
+    // 1 / kEmptyBuckets of the budget, so a sparse table drains quickly.
+    // Time - O(buckets + moved nodes)
+    // Memory - O(1)
+    void migrate(int buckets) {
+        if(!rehashing()) {
+            return;
+        }
+        UFAR_STAT(StatsTimer timer(stats_.rehash_ns);)
+        constexpr long long kEmptyBuckets = 16;
+        long long budget = buckets * kEmptyBuckets;
+        while (rehashing() && budget > 0)
         {
+            ListNode* head = old_[migrate_pos_];
+            budget -= head ? kEmptyBuckets : 1;
             while (head)
             {
-                insert(head->data, new_table);
-                head = head->next;
+                ListNode* next = head->next;
+                std::size_t index = hash(head->data, table_.size());
+                head->next = table_[index];
+                table_[index] = head;
+                head = next;
             }
-        }
+            // Drained buckets must not keep stale heads: print() and
+            // destroy_nodes() walk all of old_
+            old_[migrate_pos_] = nullptr;
 
-        std::swap(table_, new_table);
+            if(++migrate_pos_ == old_.size()) {
+                old_.clear();
+                old_.shrink_to_fit();
+            }
+        }
     }
 
-    void insert(int data, std::vector<ListNode*>& table) {
-        int index = hash(data, table.size());
+    // Bucket that currently owns data: the old one until it is migrated
+    ListNode*& bucket(const Key& data) {
+        if(rehashing()) {
+            std::size_t index = hash(data, old_.size());
+            if(index >= migrate_pos_) {
+                return old_[index];
+            }
+        }
+        return table_[hash(data, table_.size())];
+    }
 
-        ListNode* head = table[index];
-        if(head == nullptr) {
-            table[index] = new ListNode{data, nullptr};
-            ++size_;
-            return; 
+    void prefetch_group(const Key* keys, std::size_t count, ListNode** slots[]) {
+        for(std::size_t i = 0; i < count; ++i) {
+            slots[i] = &bucket(keys[i]);
+            __builtin_prefetch(slots[i]);
+        }
+        for(std::size_t i = 0; i < count; ++i) {
+            if(*slots[i] != nullptr) {
+                __builtin_prefetch(*slots[i]);
+            }
         }
+    }
 
-        while (head->next != nullptr)
+    void insert(const Key& data, ListNode*& head) {
+        UFAR_STAT(std::uint64_t length = 0;)
+        ListNode** link = &head;
+        while (*link != nullptr)
         {
-            head = head->next;
+            UFAR_STAT(++length;)
+            link = &(*link)->next;
         }
-        
-        head->next = new ListNode{data, nullptr};
+        UFAR_STAT(stats_.chain.add(length);)
+
+        *link = pool_.create(data, nullptr);
         ++size_;
     }
 
 public:
     // Time - O(N)
     // Memory - O(N)
-    HashTable(int cap)
+    // Capacity is rounded up to a power of two
+    explicit HashTable(int cap, Hash hash = Hash())
         : size_(0)
-        , table_(std::max(cap, 10), nullptr)
+        , table_(round_up_pow2(std::max(cap, 0), 16), nullptr)
+        , min_buckets_(table_.size())
+        , hash_(hash)
     {}
 
-    // Time - O(1), O(1), O(N + K)
-    // Memory - O(1), O(N + K)
-    void insert(int data) {
+    HashTable(const HashTable&) = delete;
+    HashTable& operator=(const HashTable&) = delete;
+
+    ~HashTable() {
+        destroy_nodes();
+    }
+
+    // Growth is spread over later operations, so no single insert pays O(N + K)
+    // Time - O(1) + O(K) to allocate a new array when load passes 0.5
+    // Memory - O(1), O(K)
+    void insert(const Key& data) {
+        migrate(kMigrateBuckets);
         if(get_balance_factor() > 0.5) {
-            resize();
+            migrate(static_cast<int>(old_.size()));
+            start_rehash(table_.size() * 2);
         }
 
-        insert(data, table_);
+        insert(data, bucket(data));
     }
     
     // O(1) O(N)
     // O(1)
-    bool find(int data) {
-        int index = hash(data, table_.size());
-        ListNode* head = table_[index];
+    bool find(const Key& data) {
+        migrate(kMigrateBuckets);
+        UFAR_STAT(std::uint64_t length = 0;)
+        ListNode* head = bucket(data);
         while (head)
         {
+            UFAR_STAT(++length;)
             if(head->data == data) {
+                UFAR_STAT(stats_.chain.add(length);)
                 return true;
             }
+            head = head->next;
         }
-        
+        UFAR_STAT(stats_.chain.add(length);)
         return false;
     }
 
+    // Hashes a group of keys and prefetches their buckets, then their chain
+    // heads, then resolves them, so the misses of one group overlap instead of
+    // being paid one key at a time
+    // Time - O(n) expected
+    // Memory - O(1)
+    void find_batch(const Key* keys, std::size_t n, bool* found) {
+        for(std::size_t first = 0; first < n; first += kBatch) {
+            std::size_t count = std::min(kBatch, n - first);
+            migrate(static_cast<int>(kMigrateBuckets * count));
+
+            ListNode** slots[kBatch];
+            prefetch_group(keys + first, count, slots);
+            for(std::size_t i = 0; i < count; ++i) {
+                const Key& data = keys[first + i];
+                ListNode* head = *slots[i];
+                UFAR_STAT(std::uint64_t length = head != nullptr;)
+                while (head && !(head->data == data))
+                {
+                    head = head->next;
+                    UFAR_STAT(length += head != nullptr;)
+                }
+                UFAR_STAT(stats_.chain.add(length);)
+                found[first + i] = head != nullptr;
+            }
+        }
+    }
+
+    // Sizes the table for n keys at once, finishing any rehash in progress,
+    // so the inserts up to n never grow it
+    // Time - O(N + K), nothing when the table is already big enough
+    // Memory - O(K)
+    void reserve(std::size_t n) {
+        std::size_t buckets = round_up_pow2(n * 2, 16);
+        if(buckets <= table_.size()) {
+            return;
+        }
+        migrate(static_cast<int>(old_.size()));
+        start_rehash(buckets);
+        migrate(static_cast<int>(old_.size()));
+    }
+
+    // Bulk load: same as insert() for every key, but the table is sized
+    // once up front and the group's buckets are prefetched
+    void insert_batch(const Key* keys, std::size_t n) {
+        reserve(static_cast<std::size_t>(size_) + n);
+        for(std::size_t first = 0; first < n; first += kBatch) {
+            std::size_t count = std::min(kBatch, n - first);
+            migrate(static_cast<int>(kMigrateBuckets * count));
+
+            ListNode** slots[kBatch];
+            prefetch_group(keys + first, count, slots);
+            for(std::size_t i = 0; i < count; ++i) {
+                insert(keys[first + i], *slots[i]);
+            }
+        }
+    }
+
+#if __cplusplus >= 202002L
+    void find_batch(std::span<const Key> keys, std::span<bool> found) {
+        find_batch(keys.data(), std::min(keys.size(), found.size()), found.data());
+    }
+
+    void insert_batch(std::span<const Key> keys) {
+        insert_batch(keys.data(), keys.size());
+    }
+#endif
     
-    bool erase(int data) {
-        // ...
-        return false;
+    // Unlinks one occurrence and recycles its node into the pool.
+    // Starts shrinking the table once load drops below 1 / kShrinkBelow.
+    // Time - O(1) expected
+    // Memory - O(1), O(K) to allocate a smaller array
+    bool erase(const Key& data) {
+        migrate(kMigrateBuckets);
+        ListNode** link = &bucket(data);
+        while (*link && !((*link)->data == data))
+        {
+            link = &(*link)->next;
+        }
+        if(*link == nullptr) {
+            return false;
+        }
+
+        ListNode* node = *link;
+        *link = node->next;
+        node->~ListNode();
+        pool_.recycle(node);
+        --size_;
+
+        if(!rehashing() && table_.size() > min_buckets_ &&
+           static_cast<std::size_t>(size_) * kShrinkBelow < table_.size()) {
+            start_rehash(std::max(min_buckets_, round_up_pow2(static_cast<std::size_t>(size_) * 4, 16)));
+        }
+        return true;
     }
     
     // O(1)
@@ -98,15 +400,55 @@ public:
         return size_;
     }
 
+    // Chain lengths are the nodes compared per find and the chain walked per
+    // insert; rehash time includes the incremental migration steps. Empty
+    // unless built with UFAR_STATS.
+    StatsSnapshot stats_snapshot(const std::string& prefix = "hash_table") const {
+        StatsSnapshot ans;
+#if defined(UFAR_STATS)
+        ans.add(prefix + ".size", size_);
+        ans.add(prefix + ".buckets", static_cast<double>(bucket_count()));
+        ans.add(prefix + ".load_factor", static_cast<double>(size_) / table_.size());
+        ans.add(prefix + ".chain_length", stats_.chain);
+        ans.add(prefix + ".rehash.count", static_cast<double>(stats_.rehashes));
+        ans.add(prefix + ".rehash.seconds", stats_.rehash_ns * 1e-9);
+#endif
+        (void)prefix;
+        return ans;
+    }
+
+    void reset_stats() {
+        UFAR_STAT(stats_ = Stats();)
+    }
+
+    // O(1)
+    std::size_t bucket_count() const {
+        return table_.size() + old_.size();
+    }
+
+    // All nodes go back to the pool at once
+    // Time - O(K)
+    // Memory - O(1)
+    void clear() {
+        destroy_nodes();
+        std::fill(table_.begin(), table_.end(), nullptr);
+        old_.clear();
+        pool_.clear();
+        size_ = 0;
+    }
+
     // Time - O(K + N)
     // Memory - O(1)
     void print() {
-        for (ListNode* head : table_)
+        for (const std::vector<ListNode*>* table : {&old_, &table_})
         {
-            while (head)
+            for (ListNode* head : *table)
             {
-                std::cout << head->data << std::endl;
-                head = head->next;
+                while (head)
+                {
+                    std::cout << head->data << std::endl;
+                    head = head->next;
+                }
             }
         }
     }
@@ -114,10 +456,882 @@ public:
 private:
     int size_;
     std::vector<ListNode*> table_;
+    // Buckets [migrate_pos_, old_.size()) still hold their nodes, the ones
+    // before are already empty
+    std::vector<ListNode*> old_;
+    std::size_t migrate_pos_{0};
+    // Never shrinks below the capacity it was created with
+    std::size_t min_buckets_;
+    NodePool<ListNode> pool_;
+    Hash hash_;
+#if defined(UFAR_STATS)
+    struct Stats {
+        Histogram chain;
+        std::uint64_t rehashes{0};
+        std::uint64_t rehash_ns{0};
+    };
+    Stats stats_;
+#endif
 };
 
+// Open addressing, Swiss-table style.
+// Keys and one control byte per slot live in separate arrays (SoA): a control
+// byte is kEmpty or the low 7 bits of the key's hash. A lookup loads the 16
+// control bytes starting at the home slot with one SSE2 instruction and
+// compares all of them against the 7 hash bits at once, so only real
+// candidates touch the key array. Probing is linear, one 16-slot window at
+// a time, which keeps every key between its home slot and the first empty
+// slot and lets erase shift keys back instead of leaving tombstones.
+template<typename Key, typename Hash = DefaultHash<Key>>
+class FlatHashTable {
+private:
+    static constexpr int kGroup = 16;
+    static constexpr std::int8_t kEmpty = -128;
+
+    // Bit i set: slot (pos + i) matches
+    static std::uint32_t match(const std::int8_t* group, std::int8_t value) {
+#if defined(__SSE2__)
+        __m128i ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+        return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(value))));
+#else
+        std::uint32_t mask = 0;
+        for(int i = 0; i < kGroup; ++i) {
+            mask |= static_cast<std::uint32_t>(group[i] == value) << i;
+        }
+        return mask;
+#endif
+    }
+
+    std::uint64_t hash(const Key& data) const {
+        return hash_(data);
+    }
+
+    static std::int8_t h2(std::uint64_t h) {
+        return static_cast<std::int8_t>(h & 0x7F);
+    }
+
+    std::size_t home(std::uint64_t h) const {
+        return (h >> 7) & mask_;
+    }
+
+    // The first kGroup - 1 control bytes are mirrored past the end, so a
+    // window starting at any slot is one contiguous load
+    void set_ctrl(std::size_t i, std::int8_t value) {
+        ctrl_[i] = value;
+        if(i < kGroup - 1) {
+            ctrl_[mask_ + 1 + i] = value;
+        }
+    }
+
+    // Slot holding data, or -1
+    long long find_slot(const Key& data) const {
+        return find_slot(data, hash(data));
+    }
+
+    long long find_slot(const Key& data, std::uint64_t h) const {
+        std::size_t pos = home(h);
+        UFAR_STAT(std::uint64_t windows = 0;)
+        while (true)
+        {
+            UFAR_STAT(++windows;)
+            const std::int8_t* group = ctrl_.data() + pos;
+            for(std::uint32_t m = match(group, h2(h)); m != 0; m &= m - 1) {
+                std::size_t slot = (pos + __builtin_ctz(m)) & mask_;
+                if(keys_[slot] == data) {
+                    UFAR_STAT(stats_.probe.add(windows);)
+                    return static_cast<long long>(slot);
+                }
+            }
+            if(match(group, kEmpty) != 0) {
+                UFAR_STAT(stats_.probe.add(windows);)
+                return -1;
+            }
+            pos = (pos + kGroup) & mask_;
+        }
+    }
+
+    // Inserts a key known to be absent
+    void place(Key data) {
+        std::uint64_t h = hash(data);
+        place(std::move(data), h);
+    }
+
+    void place(Key data, std::uint64_t h) {
+        std::size_t pos = home(h);
+        while (true)
+        {
+            std::uint32_t empty = match(ctrl_.data() + pos, kEmpty);
+            if(empty != 0) {
+                std::size_t slot = (pos + __builtin_ctz(empty)) & mask_;
+                set_ctrl(slot, h2(h));
+                keys_[slot] = std::move(data);
+                ++size_;
+                return;
+            }
+            pos = (pos + kGroup) & mask_;
+        }
+    }
+
+    void prefetch_group(const Key* keys, std::size_t count, std::uint64_t hashes[]) const {
+        for(std::size_t i = 0; i < count; ++i) {
+            hashes[i] = hash(keys[i]);
+            std::size_t pos = home(hashes[i]);
+            __builtin_prefetch(ctrl_.data() + pos);
+            __builtin_prefetch(keys_.data() + pos);
+        }
+    }
+
+    // Time - O(N + K)
+    // Memory - O(K)
+    void rehash(std::size_t capacity) {
+        UFAR_STAT(++stats_.rehashes; StatsTimer timer(stats_.rehash_ns);)
+        std::vector<std::int8_t> old_ctrl = std::move(ctrl_);
+        std::vector<Key> old_keys = std::move(keys_);
+        std::size_t old_capacity = mask_ + 1;
+
+        mask_ = capacity - 1;
+        ctrl_.assign(capacity + kGroup - 1, kEmpty);
+        keys_.assign(capacity, Key());
+        size_ = 0;
+        for(std::size_t i = 0; i < old_capacity; ++i) {
+            if(old_ctrl[i] != kEmpty) {
+                place(std::move(old_keys[i]));
+            }
+        }
+    }
+
+public:
+    // Capacity is rounded up to a power of two so indexing is a mask
+    explicit FlatHashTable(int cap = kGroup, Hash hash = Hash())
+        : hash_(hash)
+    {
+        std::size_t capacity = round_up_pow2(std::max(cap, 0), kGroup);
+        min_capacity_ = capacity;
+        mask_ = capacity - 1;
+        ctrl_.assign(capacity + kGroup - 1, kEmpty);
+        keys_.assign(capacity, Key());
+    }
+
+    // Time - O(1), amortized O(1) with rehash
+    // Memory - O(1), O(K) on rehash
+    // Grows at 3/4 load; returns false if data is already present
+    bool insert(const Key& data) {
+        if(find_slot(data) >= 0) {
+            return false;
+        }
+        if((size_ + 1) * 4 > (mask_ + 1) * 3) {
+            rehash((mask_ + 1) * 2);
+        }
+        place(data);
+        return true;
+    }
+
+    // Time - O(1) expected
+    // Memory - O(1)
+    bool find(const Key& data) const {
+        return find_slot(data) >= 0;
+    }
+
+    // Hashes a group of keys and prefetches their control windows and key
+    // slots before probing any of them
+    // Time - O(n) expected
+    // Memory - O(1)
+    void find_batch(const Key* keys, std::size_t n, bool* found) const {
+        for(std::size_t first = 0; first < n; first += kBatch) {
+            std::size_t count = std::min(kBatch, n - first);
+            std::uint64_t hashes[kBatch];
+            prefetch_group(keys + first, count, hashes);
+            for(std::size_t i = 0; i < count; ++i) {
+                found[first + i] = find_slot(keys[first + i], hashes[i]) >= 0;
+            }
+        }
+    }
+
+    // Rebuilds once so that n keys fit under the 3/4 limit
+    // Time - O(N + K), nothing when the table is already big enough
+    // Memory - O(K)
+    void reserve(std::size_t n) {
+        std::size_t capacity = round_up_pow2((n * 4 + 2) / 3, kGroup);
+        if(capacity > mask_ + 1) {
+            rehash(capacity);
+        }
+    }
+
+    // Returns how many keys were new. Capacity is checked once per group;
+    // repeats are not known in advance, so reserve() first for a bulk load.
+    std::size_t insert_batch(const Key* keys, std::size_t n) {
+        std::size_t inserted = 0;
+        for(std::size_t first = 0; first < n; first += kBatch) {
+            std::size_t count = std::min(kBatch, n - first);
+            while ((size_ + count) * 4 > (mask_ + 1) * 3)
+            {
+                rehash((mask_ + 1) * 2);
+            }
+
+            std::uint64_t hashes[kBatch];
+            prefetch_group(keys + first, count, hashes);
+            for(std::size_t i = 0; i < count; ++i) {
+                if(find_slot(keys[first + i], hashes[i]) < 0) {
+                    place(keys[first + i], hashes[i]);
+                    ++inserted;
+                }
+            }
+        }
+        return inserted;
+    }
+
+#if __cplusplus >= 202002L
+    void find_batch(std::span<const Key> keys, std::span<bool> found) const {
+        find_batch(keys.data(), std::min(keys.size(), found.size()), found.data());
+    }
+
+    std::size_t insert_batch(std::span<const Key> keys) {
+        return insert_batch(keys.data(), keys.size());
+    }
+#endif
+
+    // Backward-shift deletion: every later key of the cluster whose home slot
+    // is not between the hole and itself moves back into the hole, so no
+    // tombstones are left behind. Below 1/8 load the table is rebuilt for
+    // 1/4, far from the 3/4 growth limit.
+    // Time - O(1) amortized
+    // Memory - O(1), O(K) on shrink
+    bool erase(const Key& data) {
+        long long found = find_slot(data);
+        if(found < 0) {
+            return false;
+        }
+
+        std::size_t hole = static_cast<std::size_t>(found);
+        for(std::size_t next = (hole + 1) & mask_; ctrl_[next] != kEmpty; next = (next + 1) & mask_) {
+            std::size_t k = home(hash(keys_[next]));
+            bool stays = hole <= next ? (hole < k && k <= next) : (hole < k || k <= next);
+            if(stays) {
+                continue;
+            }
+            set_ctrl(hole, ctrl_[next]);
+            keys_[hole] = std::move(keys_[next]);
+            hole = next;
+        }
+        set_ctrl(hole, kEmpty);
+        --size_;
+
+        std::size_t capacity = mask_ + 1;
+        if(capacity > min_capacity_ && size_ * 8 < capacity) {
+            rehash(round_up_pow2(size_ * 4, min_capacity_));
+        }
+        return true;
+    }
+
+    // O(1)
+    int size() const {
+        return static_cast<int>(size_);
+    }
+
+    // O(1)
+    std::size_t bucket_count() const {
+        return mask_ + 1;
+    }
+
+    // Probe length is the 16-slot control windows loaded per lookup, 1 when
+    // the home window settles it. Empty unless built with UFAR_STATS, where
+    // lookups are no longer safe to run concurrently (see Stats).
+    StatsSnapshot stats_snapshot(const std::string& prefix = "flat_hash_table") const {
+        StatsSnapshot ans;
+#if defined(UFAR_STATS)
+        ans.add(prefix + ".size", static_cast<double>(size_));
+        ans.add(prefix + ".buckets", static_cast<double>(bucket_count()));
+        ans.add(prefix + ".load_factor", static_cast<double>(size_) / bucket_count());
+        ans.add(prefix + ".probe_length", stats_.probe);
+        ans.add(prefix + ".rehash.count", static_cast<double>(stats_.rehashes));
+        ans.add(prefix + ".rehash.seconds", stats_.rehash_ns * 1e-9);
+#endif
+        (void)prefix;
+        return ans;
+    }
+
+    void reset_stats() {
+        UFAR_STAT(stats_ = Stats();)
+    }
+
+    // Time - O(K)
+    // Memory - O(1)
+    void print() const {
+        for(std::size_t i = 0; i <= mask_; ++i) {
+            if(ctrl_[i] != kEmpty) {
+                std::cout << keys_[i] << std::endl;
+            }
+        }
+    }
+
+private:
+    std::vector<std::int8_t> ctrl_;
+    std::vector<Key> keys_;
+    std::size_t mask_;
+    std::size_t size_{0};
+    std::size_t min_capacity_;
+    Hash hash_;
+#if defined(UFAR_STATS)
+    // Lookups are const, so the counters are mutable. They are plain
+    // integers: in a UFAR_STATS build even const find() writes them, so
+    // concurrent readers of one table race. Stats builds of a shared
+    // read-only table are for single-threaded profiling only.
+    struct Stats {
+        Histogram probe;
+        std::uint64_t rehashes{0};
+        std::uint64_t rehash_ns{0};
+    };
+    mutable Stats stats_;
+#endif
+};
+
+// Set that keeps its first Inline keys inside the object and only moves to a
+// FlatHashTable on the heap past that. Most per-node and per-request sets
+// hold a handful of keys; for them a lookup is a scan of at most Inline keys
+// in the object's own cache lines, nothing is hashed and nothing is
+// allocated. Once spilled it stays a FlatHashTable until clear().
+template<typename Key, int Inline = 8, typename Hash = DefaultHash<Key>>
+class SmallHashTable {
+public:
+    static_assert(Inline > 0, "SmallHashTable needs at least one inline key");
+
+    explicit SmallHashTable(Hash hash = Hash())
+        : hash_(hash)
+    {}
+
+    // Time - O(Inline), O(1) expected once spilled
+    // Memory - O(1), O(Inline) on spill
+    // Returns false if data is already present
+    bool insert(const Key& data) {
+        if(spill_) {
+            return spill_->insert(data);
+        }
+        if(find_inline(data) >= 0) {
+            return false;
+        }
+        if(size_ < Inline) {
+            keys_[size_++] = data;
+            return true;
+        }
+        spill();
+        return spill_->insert(data);
+    }
+
+    // Time - O(Inline), O(1) expected once spilled
+    // Memory - O(1)
+    bool find(const Key& data) const {
+        return spill_ ? spill_->find(data) : find_inline(data) >= 0;
+    }
+
+    // The last inline key moves into the hole, so the keys stay packed
+    // Time - O(Inline), O(1) amortized once spilled
+    // Memory - O(1)
+    bool erase(const Key& data) {
+        if(spill_) {
+            return spill_->erase(data);
+        }
+        int i = find_inline(data);
+        if(i < 0) {
+            return false;
+        }
+        --size_;
+        keys_[i] = std::move(keys_[size_]);
+        keys_[size_] = Key();
+        return true;
+    }
+
+    // O(1)
+    int size() const {
+        return spill_ ? spill_->size() : size_;
+    }
+
+    // O(1)
+    bool spilled() const {
+        return spill_ != nullptr;
+    }
+
+    // Frees the spill table, if any, and goes back to inline storage
+    // Time - O(Inline + K)
+    void clear() {
+        spill_.reset();
+        keys_.fill(Key());
+        size_ = 0;
+    }
+
+    // Size and whether the keys spilled, plus the spill table's own stats.
+    // Empty unless built with UFAR_STATS.
+    StatsSnapshot stats_snapshot(const std::string& prefix = "small_hash_table") const {
+        StatsSnapshot ans;
+#if defined(UFAR_STATS)
+        ans.add(prefix + ".size", static_cast<double>(size()));
+        ans.add(prefix + ".spilled", spilled() ? 1.0 : 0.0);
+        if(spill_) {
+            ans.add(spill_->stats_snapshot(prefix + ".spill"));
+        }
+#endif
+        (void)prefix;
+        return ans;
+    }
+
+    // Time - O(Inline + K)
+    // Memory - O(1)
+    void print() const {
+        if(spill_) {
+            spill_->print();
+            return;
+        }
+        for(int i = 0; i < size_; ++i) {
+            std::cout << keys_[i] << std::endl;
+        }
+    }
+
+private:
+    int find_inline(const Key& data) const {
+        for(int i = 0; i < size_; ++i) {
+            if(keys_[i] == data) {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    // Moves the inline keys to a heap table of Inline * 4 slots, which at its
+    // 3/4 load limit holds 3 * Inline keys (24 for Inline = 8) before its
+    // first rehash
+    // Time - O(Inline)
+    // Memory - O(Inline)
+    void spill() {
+        spill_ = std::make_unique<FlatHashTable<Key, Hash>>(Inline * 4, hash_);
+        for(int i = 0; i < size_; ++i) {
+            spill_->insert(keys_[i]);
+        }
+        keys_.fill(Key());
+        size_ = 0;
+    }
+
+    std::array<Key, Inline> keys_{};
+    int size_{0};
+    std::unique_ptr<FlatHashTable<Key, Hash>> spill_;
+    Hash hash_;
+};
+
+// Epoch-based reclamation shared by every concurrent structure in the process.
+// A reader pins the current global epoch for the duration of a Guard. Memory
+// unlinked at epoch e is freed once the global epoch reaches e + 2: by then
+// every thread has been outside a Guard or has re-pinned a later epoch, so
+// nobody can still hold a pointer into it.
+class EpochDomain {
+private:
+    static constexpr std::uint64_t kIdle = ~std::uint64_t{0};
+    static constexpr int kMaxThreads = 512;
+    static constexpr std::size_t kCollectEvery = 128;
+
+    struct alignas(64) Slot {
+        std::atomic<std::uint64_t> epoch{kIdle};
+        std::atomic<bool> used{false};
+    };
+
+    struct Retired {
+        void* p;
+        void (*deleter)(void*);
+        std::uint64_t epoch;
+    };
+
+    // Per-thread registration; what is left at thread exit goes to the orphans
+    struct ThreadState {
+        explicit ThreadState(EpochDomain& domain)
+            : domain(domain)
+            , slot(domain.acquire_slot())
+        {}
+
+        ~ThreadState() {
+            domain.try_advance();
+            domain.collect(retired);
+            {
+                std::lock_guard<std::mutex> lock(domain.orphans_mutex_);
+                domain.orphans_.insert(domain.orphans_.end(), retired.begin(), retired.end());
+            }
+            slot->epoch.store(kIdle, std::memory_order_release);
+            slot->used.store(false, std::memory_order_release);
+        }
+
+        void enter() {
+            if(depth++ == 0) {
+                slot->epoch.store(domain.global_.load(std::memory_order_seq_cst), std::memory_order_seq_cst);
+            }
+        }
+
+        void exit() {
+            if(--depth == 0) {
+                slot->epoch.store(kIdle, std::memory_order_release);
+            }
+        }
+
+        EpochDomain& domain;
+        Slot* slot;
+        std::vector<Retired> retired;
+        int depth{0};
+    };
+
+    ThreadState& local() {
+        thread_local ThreadState state(*this);
+        return state;
+    }
+
+    Slot* acquire_slot() {
+        for(Slot& slot : slots_) {
+            bool expected = false;
+            if(slot.used.compare_exchange_strong(expected, true)) {
+                return &slot;
+            }
+        }
+        throw std::runtime_error("EpochDomain: too many threads");
+    }
+
+    // The global epoch moves on only when every pinned thread has seen it
+    void try_advance() {
+        std::uint64_t epoch = global_.load(std::memory_order_seq_cst);
+        for(const Slot& slot : slots_) {
+            if(!slot.used.load(std::memory_order_acquire)) {
+                continue;
+            }
+            std::uint64_t seen = slot.epoch.load(std::memory_order_seq_cst);
+            if(seen != kIdle && seen != epoch) {
+                return;
+            }
+        }
+        global_.compare_exchange_strong(epoch, epoch + 1, std::memory_order_seq_cst);
+    }
+
+    // seq_cst like the pin and advance paths, which this load pairs with
+    void collect(std::vector<Retired>& retired) {
+        std::uint64_t epoch = global_.load(std::memory_order_seq_cst);
+        std::size_t kept = 0;
+        for(const Retired& r : retired) {
+            if(r.epoch + 2 <= epoch) {
+                r.deleter(r.p);
+            } else {
+                retired[kept++] = r;
+            }
+        }
+        retired.resize(kept);
+    }
+
+    void collect_orphans() {
+        std::unique_lock<std::mutex> lock(orphans_mutex_, std::try_to_lock);
+        if(lock.owns_lock()) {
+            collect(orphans_);
+        }
+    }
+
+public:
+    static EpochDomain& instance() {
+        static EpochDomain domain;
+        return domain;
+    }
+
+    class Guard {
+    public:
+        Guard()
+            : state_(EpochDomain::instance().local())
+        {
+            state_.enter();
+        }
+
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+
+        ~Guard() {
+            state_.exit();
+        }
+
+    private:
+        ThreadState& state_;
+    };
+
+    ~EpochDomain() {
+        for(const Retired& r : orphans_) {
+            r.deleter(r.p);
+        }
+    }
+
+    // Frees p with deleter once no Guard can still see it. The caller has
+    // just unlinked p, usually with a release store; the fence orders that
+    // store before the epoch load (StoreLoad), so p cannot be stamped with
+    // an epoch older than the unlink and freed under a reader pinned after.
+    void retire(void* p, void (*deleter)(void*)) {
+        ThreadState& state = local();
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        state.retired.push_back(Retired{p, deleter, global_.load(std::memory_order_seq_cst)});
+        if(state.retired.size() >= kCollectEvery) {
+            try_advance();
+            collect(state.retired);
+            collect_orphans();
+        }
+    }
+
+private:
+    Slot slots_[kMaxThreads];
+    std::atomic<std::uint64_t> global_{2};
+    std::mutex orphans_mutex_;
+    std::vector<Retired> orphans_;
+};
+
+// Chained hash set for many threads.
+// find() takes no lock and never retries: it pins an epoch and walks a chain
+// whose links are only ever replaced with release stores. insert() and
+// erase() lock one of kStripes mutexes, picked by the low hash bits, so
+// writers to different stripes never contend. Capacities are powers of two
+// >= kStripes, which keeps a bucket in the same stripe at every size.
+// Growing is cooperative: the writer that crosses the load limit publishes a
+// table twice as large, and every later writer migrates a few old buckets
+// under their stripe lock before its own operation. A migrated bucket holds a
+// forwarding marker that sends readers and writers to the new table, so
+// nothing ever waits for the whole table to be copied.
+template<typename Key, typename Hash = DefaultHash<Key>>
+class ConcurrentHashTable {
+private:
+    struct Node {
+        Key data;
+        std::atomic<Node*> next;
+    };
+
+    struct Table {
+        explicit Table(std::size_t capacity)
+            : mask(capacity - 1)
+            , buckets(new std::atomic<Node*>[capacity])
+        {
+            for(std::size_t i = 0; i < capacity; ++i) {
+                buckets[i].store(nullptr, std::memory_order_relaxed);
+            }
+        }
+
+        std::size_t capacity() const {
+            return mask + 1;
+        }
+
+        std::size_t mask;
+        std::unique_ptr<std::atomic<Node*>[]> buckets;
+        std::atomic<Table*> next{nullptr};
+        std::atomic<std::size_t> claimed{0};
+        std::atomic<std::size_t> moved{0};
+    };
+
+    struct alignas(64) Stripe {
+        std::mutex mutex;
+    };
+
+    static constexpr std::size_t kStripes = 64;
+    static constexpr std::size_t kMigrateBuckets = 8;
+
+    // Never dereferenced, only compared
+    static Node* forwarded() {
+        static char marker;
+        return reinterpret_cast<Node*>(&marker);
+    }
+
+    static void delete_node(void* p) {
+        delete static_cast<Node*>(p);
+    }
+
+    static void delete_table(void* p) {
+        delete static_cast<Table*>(p);
+    }
+
+    std::mutex& stripe(std::uint64_t h) {
+        return stripes_[h & (kStripes - 1)].mutex;
+    }
+
+    // Table that owns h's bucket; stable while h's stripe is locked
+    Table* table_for(std::uint64_t h) const {
+        Table* t = table_.load(std::memory_order_acquire);
+        while (t->buckets[h & t->mask].load(std::memory_order_acquire) == forwarded())
+        {
+            t = t->next.load(std::memory_order_acquire);
+        }
+        return t;
+    }
+
+    // Copies old bucket i into its two halves in t->next, then forwards it.
+    // Old nodes are retired, not changed, so readers already inside finish
+    // their walk on a consistent chain.
+    void migrate(Table* t, std::size_t i) {
+        Table* n = t->next.load(std::memory_order_acquire);
+        std::vector<Node*> old_nodes;
+        {
+            std::lock_guard<std::mutex> lock(stripes_[i & (kStripes - 1)].mutex);
+            Node* lo = nullptr;
+            Node* hi = nullptr;
+            for(Node* node = t->buckets[i].load(std::memory_order_relaxed); node != nullptr;
+                node = node->next.load(std::memory_order_relaxed)) {
+                bool upper = (hash_(node->data) & n->mask) != i;
+                Node*& head = upper ? hi : lo;
+                head = new Node{node->data, head};
+                old_nodes.push_back(node);
+            }
+            n->buckets[i].store(lo, std::memory_order_release);
+            n->buckets[i + t->capacity()].store(hi, std::memory_order_release);
+            t->buckets[i].store(forwarded(), std::memory_order_release);
+        }
+
+        for(Node* node : old_nodes) {
+            EpochDomain::instance().retire(node, &delete_node);
+        }
+
+        if(t->moved.fetch_add(1, std::memory_order_acq_rel) + 1 == t->capacity()) {
+            table_.store(n, std::memory_order_release);
+            EpochDomain::instance().retire(t, &delete_table);
+        }
+    }
+
+    void help_migrate() {
+        Table* t = table_.load(std::memory_order_acquire);
+        if(t->next.load(std::memory_order_acquire) == nullptr) {
+            return;
+        }
+        for(std::size_t k = 0; k < kMigrateBuckets; ++k) {
+            std::size_t i = t->claimed.fetch_add(1, std::memory_order_relaxed);
+            if(i >= t->capacity()) {
+                return;
+            }
+            migrate(t, i);
+        }
+    }
+
+    // Publishes a doubled table once load passes 3/4; one resize at a time
+    void maybe_grow() {
+        Table* t = table_.load(std::memory_order_acquire);
+        if(size_.load(std::memory_order_relaxed) * 4 <= t->capacity() * 3 ||
+           t->next.load(std::memory_order_acquire) != nullptr) {
+            return;
+        }
+        Table* bigger = new Table(t->capacity() * 2);
+        Table* expected = nullptr;
+        if(!t->next.compare_exchange_strong(expected, bigger, std::memory_order_acq_rel)) {
+            delete bigger;
+        }
+    }
+
+public:
+    explicit ConcurrentHashTable(int cap = kStripes, Hash hash = Hash())
+        : table_(new Table(round_up_pow2(std::max(cap, 0), kStripes)))
+        , hash_(hash)
+    {}
+
+    ConcurrentHashTable(const ConcurrentHashTable&) = delete;
+    ConcurrentHashTable& operator=(const ConcurrentHashTable&) = delete;
+
+    // No other thread may use the table any more
+    ~ConcurrentHashTable() {
+        for(Table* t = table_.load(); t != nullptr; ) {
+            for(std::size_t i = 0; i < t->capacity(); ++i) {
+                Node* node = t->buckets[i].load(std::memory_order_relaxed);
+                if(node == forwarded()) {
+                    continue;
+                }
+                while (node)
+                {
+                    Node* next = node->next.load(std::memory_order_relaxed);
+                    delete node;
+                    node = next;
+                }
+            }
+            Table* next = t->next.load();
+            delete t;
+            t = next;
+        }
+    }
+
+    // Time - O(1) expected
+    // Wait-free: no locks, no retries
+    bool find(const Key& data) const {
+        EpochDomain::Guard guard;
+        std::uint64_t h = hash_(data);
+        Table* t = table_.load(std::memory_order_acquire);
+        Node* node = t->buckets[h & t->mask].load(std::memory_order_acquire);
+        while (node == forwarded())
+        {
+            t = t->next.load(std::memory_order_acquire);
+            node = t->buckets[h & t->mask].load(std::memory_order_acquire);
+        }
+        for(; node != nullptr; node = node->next.load(std::memory_order_acquire)) {
+            if(node->data == data) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Returns false if data is already present
+    // Time - O(1) expected
+    bool insert(const Key& data) {
+        EpochDomain::Guard guard;
+        help_migrate();
+
+        std::uint64_t h = hash_(data);
+        {
+            std::lock_guard<std::mutex> lock(stripe(h));
+            Table* t = table_for(h);
+            std::atomic<Node*>& bucket = t->buckets[h & t->mask];
+            Node* head = bucket.load(std::memory_order_relaxed);
+            for(Node* node = head; node != nullptr; node = node->next.load(std::memory_order_relaxed)) {
+                if(node->data == data) {
+                    return false;
+                }
+            }
+            bucket.store(new Node{data, head}, std::memory_order_release);
+        }
+
+        size_.fetch_add(1, std::memory_order_relaxed);
+        maybe_grow();
+        return true;
+    }
+
+    // Time - O(1) expected
+    bool erase(const Key& data) {
+        EpochDomain::Guard guard;
+        help_migrate();
+
+        std::uint64_t h = hash_(data);
+        Node* victim = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(stripe(h));
+            Table* t = table_for(h);
+            std::atomic<Node*>* link = &t->buckets[h & t->mask];
+            for(Node* node = link->load(std::memory_order_relaxed); node != nullptr;
+                link = &node->next, node = link->load(std::memory_order_relaxed)) {
+                if(node->data == data) {
+                    link->store(node->next.load(std::memory_order_relaxed), std::memory_order_release);
+                    victim = node;
+                    break;
+                }
+            }
+        }
+
+        if(victim == nullptr) {
+            return false;
+        }
+        EpochDomain::instance().retire(victim, &delete_node);
+        size_.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Exact when no writer is running
+    int size() const {
+        return static_cast<int>(size_.load(std::memory_order_relaxed));
+    }
+
+private:
+    std::atomic<Table*> table_;
+    Stripe stripes_[kStripes];
+    std::atomic<std::size_t> size_{0};
+    Hash hash_;
+};
+
+// Define UFAR_NO_MAIN to include this file from a benchmark or another driver
+#ifndef UFAR_NO_MAIN
 int main() {
-    HashTable table(10);
+    HashTable<int> table(10);
 
     table.insert(1);
     table.insert(15);
@@ -128,4 +1342,126 @@ int main() {
     table.insert(12);
 
     table.print();
+
+    std::cout << "--------------------------" << std::endl;
+
+    FlatHashTable<int> flat;
+    for(int i = 0; i < 100; ++i) {
+        flat.insert(i * 7);
+    }
+    flat.insert(-3);
+    flat.erase(14);
+    std::cout << flat.size() << " " << flat.find(7) << " " << flat.find(14) << " " << flat.find(-3) << std::endl;
+
+    std::cout << "--------------------------" << std::endl;
+
+    HashTable<std::string> words(4);
+    for(const char* w : {"apple", "banana", "cherry", "a much longer key than sixteen bytes"}) {
+        words.insert(w);
+    }
+    std::cout << words.size() << " " << words.find("banana") << " " << words.find("durian") << std::endl;
+
+    std::vector<int> probe{7, 14, 21, 700, -3};
+    bool hits[5];
+    flat.find_batch(probe.data(), probe.size(), hits);
+    table.insert_batch(probe.data(), probe.size());
+    for(bool hit : hits) {
+        std::cout << hit << " ";
+    }
+    std::cout << table.size() << std::endl;
+
+    // A burst, then eviction: the tables shrink back with the live set
+    HashTable<int> cache(16);
+    for(int i = 0; i < 100000; ++i) {
+        cache.insert(i);
+    }
+    std::size_t peak = cache.bucket_count();
+    for(int i = 0; i < 99990; ++i) {
+        cache.erase(i);
+    }
+    for(int i = 0; i < 10000; ++i) {
+        cache.find(i);
+    }
+    std::cout << cache.size() << " " << peak << " -> " << cache.bucket_count() << std::endl;
+
+    // Destroyed and cleared in the middle of an incremental rehash: every
+    // key is destroyed exactly once
+    {
+        HashTable<std::string> growing(16);
+        for(int i = 0; i < 1028; ++i) {
+            growing.insert("a key too long for the small string buffer " + std::to_string(i));
+        }
+        std::size_t mid_rehash = growing.bucket_count();
+        HashTable<std::string> cleared(16);
+        for(int i = 0; i < 1028; ++i) {
+            cleared.insert("another key too long for the small string buffer " + std::to_string(i));
+        }
+        cleared.clear();
+        std::cout << growing.size() << " " << mid_rehash << " " << cleared.size() << std::endl;
+    }
+
+    FlatHashTable<std::string> flat_words;
+    flat_words.insert("apple");
+    std::cout << flat_words.find("apple") << " " << flat_words.find("pear") << std::endl;
+
+    // Bulk load: one allocation of the final size instead of a growth chain
+    std::vector<int> bulk(50000);
+    for(int i = 0; i < 50000; ++i) {
+        bulk[i] = i * 3;
+    }
+    HashTable<int> loaded(16);
+    loaded.insert_batch(bulk.data(), bulk.size());
+    FlatHashTable<int> flat_loaded;
+    flat_loaded.reserve(bulk.size());
+    std::size_t reserved = flat_loaded.bucket_count();
+    flat_loaded.insert_batch(bulk.data(), bulk.size());
+    std::cout << loaded.size() << " " << loaded.bucket_count() << " " << (reserved == flat_loaded.bucket_count()) << std::endl;
+
+    // Small sets stay inside the object until the ninth key
+    SmallHashTable<std::string> tags;
+    for(const char* t : {"red", "green", "blue", "green"}) {
+        tags.insert(t);
+    }
+    tags.erase("red");
+    std::cout << tags.size() << " " << tags.find("blue") << " " << tags.find("red") << " " << tags.spilled();
+    for(int i = 0; i < 10; ++i) {
+        tags.insert("tag" + std::to_string(i));
+    }
+    std::cout << " " << tags.size() << " " << tags.find("green") << " " << tags.spilled() << std::endl;
+
+#if defined(UFAR_STATS)
+    // Build with -DUFAR_STATS for chain/probe histograms and rehash cost
+    StatsSnapshot metrics = loaded.stats_snapshot();
+    metrics.add(flat_loaded.stats_snapshot());
+    metrics.write_json(std::cout);
+    std::cout << std::endl;
+#endif
+
+    std::cout << "--------------------------" << std::endl;
+
+    // Each writer owns a key range; readers probe all of them meanwhile
+    ConcurrentHashTable<int> shared;
+    std::vector<std::thread> workers;
+    for(int t = 0; t < 4; ++t) {
+        workers.emplace_back([&shared, t] {
+            for(int i = 0; i < 10000; ++i) {
+                shared.insert(t * 100000 + i);
+            }
+            for(int i = 0; i < 10000; i += 2) {
+                shared.erase(t * 100000 + i);
+            }
+        });
+        workers.emplace_back([&shared] {
+            int hits = 0;
+            for(int i = 0; i < 40000; ++i) {
+                hits += shared.find(i);
+            }
+            (void)hits;
+        });
+    }
+    for(std::thread& worker : workers) {
+        worker.join();
+    }
+    std::cout << shared.size() << " " << shared.find(1) << " " << shared.find(2) << std::endl;
 }
+#endif
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Read-only shared mapping of a whole file. Pages are loaded on first
+// touch and are shared with every other process mapping the same file.
+// An empty file opens with size() == 0 and data() == nullptr.
+class MappedFile {
+public:
+    MappedFile() = default;
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile() {
+        close();
+    }
+
+    // Time - O(1)
+    bool open(const std::string& path) {
+        close();
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if(fd < 0) {
+            return false;
+        }
+        struct stat st{};
+        if(fstat(fd, &st) != 0) {
+            ::close(fd);
+            return false;
+        }
+
+        void* data = nullptr;
+        if(st.st_size > 0) {
+            data = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        }
+        ::close(fd);
+        if(data == MAP_FAILED) {
+            return false;
+        }
+        data_ = static_cast<const char*>(data);
+        size_ = st.st_size;
+        open_ = true;
+        return true;
+    }
+
+    void close() {
+        if(data_ != nullptr) {
+            munmap(const_cast<char*>(data_), size_);
+        }
+        data_ = nullptr;
+        size_ = 0;
+        open_ = false;
+    }
+
+    // Tells the kernel to read ahead aggressively for one front-to-back pass
+    void sequential() const {
+        if(data_ != nullptr) {
+            madvise(const_cast<char*>(data_), size_, MADV_SEQUENTIAL);
+        }
+    }
+
+    bool is_open() const {
+        return open_;
+    }
+
+    const char* data() const {
+        return data_;
+    }
+
+    std::size_t size() const {
+        return size_;
+    }
+
+private:
+    const char* data_{nullptr};
+    std::size_t size_{0};
+    bool open_{false};
+};
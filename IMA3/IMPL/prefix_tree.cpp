@@ -1,51 +1,507 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <queue>
+#include <string>
 #include <string_view>
+#include <type_traits>
 #include <array>
 #include <vector>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "arena.h"
+#include "mapped_file.h"
+#include "stats.h"
+
+// Pointer-free trie image written by PrefixTree::freeze and read in place
+// by PrefixTreeSnapshot. Nodes are numbered in BFS order, so the children of
+// a node are consecutive and sorted by byte. The shape is a LOUDS bit
+// string: every node in turn writes one 1 per child and then a 0, and
+// node i's children follow from the positions of the (i-1)-th and i-th 0.
+// Every section is an array of fixed-width integers at a fixed offset.
+//   louds         2N - 1 bits
+//   zero_rank     zeros before each louds word, for select0
+//   samples       louds word holding every kSelectSample-th zero
+//   terminal      1 bit per node, set for words
+//   terminal_rank ones before each terminal word
+//   labels        edge byte into each node
+//   counts        cnt of each word, indexed by rank in terminal
+//   max_counts    largest cnt in each node's subtree
+struct SnapshotLayout {
+    static constexpr std::uint64_t kMagic = 0x31535254'52414655ULL;
+    static constexpr std::uint64_t kSelectSample = 64;
+
+    struct Header {
+        std::uint64_t magic;
+        std::uint64_t nodes;
+        std::uint64_t words;
+    };
+
+    SnapshotLayout(std::uint64_t node_count, std::uint64_t word_count)
+        : nodes(node_count)
+        , words(word_count)
+    {
+        louds_words = (2 * nodes - 1 + 63) / 64;
+        terminal_words = (nodes + 63) / 64;
+        std::size_t at = sizeof(Header);
+        louds = take(at, louds_words * 8);
+        zero_rank = take(at, (louds_words + 1) * 4);
+        samples = take(at, (nodes + kSelectSample - 1) / kSelectSample * 4);
+        terminal = take(at, terminal_words * 8);
+        terminal_rank = take(at, terminal_words * 4);
+        labels = take(at, nodes);
+        counts = take(at, words * 4);
+        max_counts = take(at, nodes * 4);
+        bytes = at;
+    }
+
+    static std::size_t take(std::size_t& at, std::size_t size) {
+        std::size_t offset = at;
+        at = (at + size + 7) / 8 * 8;
+        return offset;
+    }
+
+    std::uint64_t nodes;
+    std::uint64_t words;
+    std::uint64_t louds_words;
+    std::uint64_t terminal_words;
+    std::size_t louds, zero_rank, samples, terminal, terminal_rank, labels, counts, max_counts, bytes;
+};
+
+// Symbol sets a PrefixTree can be specialised for. Bytes takes any string;
+// a fixed alphabet lists its symbols in kSymbols and gets one direct child
+// slot per symbol, e.g. PrefixTree<Alphabet::Digits> for phone numbers.
+namespace Alphabet {
+struct Bytes {};
+
+struct Digits {
+    static constexpr std::string_view kSymbols = "0123456789";
+};
+
+struct Lowercase {
+    static constexpr std::string_view kSymbols = "abcdefghijklmnopqrstuvwxyz";
+};
+}
+
+// Byte -> child slot tables of an alphabet, built at compile time. Slots
+// follow byte order whatever the order of kSymbols, so children still
+// come out sorted; bytes outside the alphabet map to -1.
+template<typename Chars>
+constexpr std::array<std::int16_t, 256> alphabet_slots() {
+    std::array<std::int16_t, 256> slot{};
+    for(int b = 0; b < 256; ++b) {
+        slot[b] = -1;
+    }
+    for(char c : Chars::kSymbols) {
+        slot[static_cast<unsigned char>(c)] = 0;
+    }
+    std::int16_t next = 0;
+    for(int b = 0; b < 256; ++b) {
+        if(slot[b] == 0) {
+            slot[b] = next++;
+        }
+    }
+    return slot;
+}
+
+template<int Size>
+constexpr std::array<unsigned char, Size> alphabet_symbols(const std::array<std::int16_t, 256>& slot) {
+    std::array<unsigned char, Size> symbol{};
+    for(int b = 0; b < 256; ++b) {
+        if(slot[b] >= 0) {
+            symbol[slot[b]] = static_cast<unsigned char>(b);
+        }
+    }
+    return symbol;
+}
+
+constexpr int alphabet_size(const std::array<std::int16_t, 256>& slot) {
+    int n = 0;
+    for(std::int16_t s : slot) {
+        n += s >= 0;
+    }
+    return n;
+}
+
+template<typename Chars, typename = void>
+struct AlphabetTraits {
+    static constexpr bool kFixed = false;
+    static constexpr int kSize = 256;
+
+    static constexpr bool contains(std::string_view) {
+        return true;
+    }
+};
+
+template<typename Chars>
+struct AlphabetTraits<Chars, std::void_t<decltype(Chars::kSymbols)>> {
+    static constexpr bool kFixed = true;
+    static constexpr std::array<std::int16_t, 256> kSlot = alphabet_slots<Chars>();
+    static constexpr int kSize = alphabet_size(kSlot);
+    static constexpr std::array<unsigned char, kSize> kSymbol = alphabet_symbols<kSize>(kSlot);
+
+    static constexpr int slot(char c) {
+        return kSlot[static_cast<unsigned char>(c)];
+    }
+
+    // Time : O(N)
+    static constexpr bool contains(std::string_view word) {
+        for(char c : word) {
+            if(slot(c) < 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+template<typename Chars = Alphabet::Bytes>
 class PrefixTree {
+public:
+    // Completions cached per node, enough for the top-5 autocomplete query
+    static constexpr int kTopK = 5;
+
+private:
+    struct TreeNode;
+    using Traits = AlphabetTraits<Chars>;
+
+    // With Alphabet::Bytes, child storage grows with the fan-out instead of
+    // reserving a slot for every byte: up to 4 children sit inline in the node, up to 16 in a
+    // sorted Small block searched with one SSE2 compare, past that a Dense
+    // block indexed by the byte. Keys are compared as unsigned bytes, so
+    // any UTF-8 (or binary) string is a valid word and children stay in
+    // byte order, which for UTF-8 is also code point order.
+    static constexpr int kInline = 4;
+    static constexpr int kSmall = 16;
+
+    struct Small {
+        std::array<unsigned char, kSmall> keys;
+        std::array<TreeNode*, kSmall> kids;
+    };
+
+    // present mirrors the non-null kids, so walking the children reads
+    // only the cache lines that hold some instead of all 2 KB
+    struct Dense {
+        std::array<std::uint64_t, 4> present;
+        std::array<TreeNode*, 256> kids;
+
+        void set(unsigned char c, TreeNode* child) {
+            kids[c] = child;
+            present[c / 64] |= 1ULL << (c % 64);
+        }
+    };
+
+    struct Pools {
+        NodePool<TreeNode> nodes;
+        NodePool<Small> small;
+        NodePool<Dense> dense;
+
+        void clear() {
+            nodes.clear();
+            small.clear();
+            dense.clear();
+        }
+    };
+
+    // Child storage for Alphabet::Bytes
+    struct TieredKids {
+        // Time : O(1)
+        TreeNode* get(unsigned char c) const {
+            if(size <= kInline) {
+                for(int i = 0; i < size; ++i) {
+                    if(keys[i] == c) {
+                        return inline_kids[i];
+                    }
+                }
+                return nullptr;
+            }
+            if(size <= kSmall) {
+                int i = find_small(c);
+                return i < 0 ? nullptr : small->kids[i];
+            }
+            return dense->kids[c];
+        }
+
+        // Time : O(kSmall), O(256) once when a node turns dense
+        void add(unsigned char c, TreeNode* child, Pools& pool) {
+            if(size < kInline) {
+                int i = size;
+                for(; i > 0 && keys[i - 1] > c; --i) {
+                    keys[i] = keys[i - 1];
+                    inline_kids[i] = inline_kids[i - 1];
+                }
+                keys[i] = c;
+                inline_kids[i] = child;
+            } else if(size < kSmall) {
+                if(size == kInline) {
+                    Small* block = pool.small.create();
+                    std::copy(keys.begin(), keys.end(), block->keys.begin());
+                    std::copy(inline_kids.begin(), inline_kids.end(), block->kids.begin());
+                    small = block;
+                }
+                int i = size;
+                for(; i > 0 && small->keys[i - 1] > c; --i) {
+                    small->keys[i] = small->keys[i - 1];
+                    small->kids[i] = small->kids[i - 1];
+                }
+                small->keys[i] = c;
+                small->kids[i] = child;
+            } else {
+                if(size == kSmall) {
+                    Dense* block = pool.dense.create();
+                    block->present.fill(0);
+                    block->kids.fill(nullptr);
+                    for(int i = 0; i < kSmall; ++i) {
+                        block->set(small->keys[i], small->kids[i]);
+                    }
+                    pool.small.recycle(small);
+                    dense = block;
+                }
+                dense->set(c, child);
+            }
+            ++size;
+        }
+
+        template<typename F>
+        void for_each_edge(F&& f) const {
+            if(size <= kInline) {
+                for(int i = 0; i < size; ++i) {
+                    f(keys[i], inline_kids[i]);
+                }
+            } else if(size <= kSmall) {
+                for(int i = 0; i < size; ++i) {
+                    f(small->keys[i], small->kids[i]);
+                }
+            } else {
+                for(int w = 0; w < 4; ++w) {
+                    for(std::uint64_t bits = dense->present[w]; bits != 0; bits &= bits - 1) {
+                        int c = w * 64 + __builtin_ctzll(bits);
+                        f(static_cast<unsigned char>(c), dense->kids[c]);
+                    }
+                }
+            }
+        }
+
+        // Slots are positions in the sorted array, or bytes once dense
+        TreeNode* child_after(int& pos) const {
+            if(size <= kSmall) {
+                if(pos >= size) {
+                    return nullptr;
+                }
+                return size <= kInline ? inline_kids[pos++] : small->kids[pos++];
+            }
+            for(; pos < 256; pos = (pos / 64 + 1) * 64) {
+                std::uint64_t bits = dense->present[pos / 64] >> (pos % 64);
+                if(bits != 0) {
+                    pos += __builtin_ctzll(bits);
+                    return dense->kids[pos++];
+                }
+            }
+            return nullptr;
+        }
+
+        int find_small(unsigned char c) const {
+#if defined(__SSE2__)
+            __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(small->keys.data()));
+            unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, _mm_set1_epi8(static_cast<char>(c)))));
+            mask &= (1u << size) - 1;
+            return mask ? __builtin_ctz(mask) : -1;
+#else
+            for(int i = 0; i < size; ++i) {
+                if(small->keys[i] == c) {
+                    return i;
+                }
+            }
+            return -1;
+#endif
+        }
+
+        // Children, sorted by byte while inline or Small
+        std::uint16_t size{};
+        std::array<unsigned char, kInline> keys{};
+        union {
+            std::array<TreeNode*, kInline> inline_kids{};
+            Small* small;
+            Dense* dense;
+        };
+    };
+
+    // Child storage for a fixed alphabet: one slot per symbol, found through
+    // the compile-time byte -> slot table, so a step is a load and an index
+    // with no search and no tier checks. Slots are in byte order.
+    struct DirectKids {
+        // Time : O(1)
+        TreeNode* get(unsigned char c) const {
+            int slot = Traits::kSlot[c];
+            return slot < 0 ? nullptr : kids[slot];
+        }
+
+        // c is known to be in the alphabet
+        // Time : O(1)
+        void add(unsigned char c, TreeNode* child, Pools&) {
+            kids[Traits::kSlot[c]] = child;
+            ++size;
+        }
+
+        template<typename F>
+        void for_each_edge(F&& f) const {
+            for(int slot = 0; slot < Traits::kSize; ++slot) {
+                if(kids[slot] != nullptr) {
+                    f(Traits::kSymbol[slot], kids[slot]);
+                }
+            }
+        }
+
+        TreeNode* child_after(int& pos) const {
+            while (pos < Traits::kSize)
+            {
+                TreeNode* child = kids[pos++];
+                if(child != nullptr) {
+                    return child;
+                }
+            }
+            return nullptr;
+        }
+
+        std::uint16_t size{};
+        std::array<TreeNode*, Traits::kSize> kids{};
+    };
+
+    using Kids = std::conditional_t<Traits::kFixed, DirectKids, TieredKids>;
+
     struct TreeNode {
         TreeNode() {
-            next.fill(nullptr);
             cnt = 0;
             is_word = false;
         }
 
-        TreeNode* get_node(char c) {
-            return next[c - 'a'];
+        // Time : O(1)
+        TreeNode* get_node(char ch) const {
+            return kids.get(static_cast<unsigned char>(ch));
+        }
+
+        // Time : O(kSmall), O(256) once when a node turns dense
+        TreeNode* set_node(char ch, Pools& pool) {
+            TreeNode* child = pool.nodes.create();
+            child->parent = this;
+            child->c = ch;
+            kids.add(static_cast<unsigned char>(ch), child, pool);
+            return child;
+        }
+
+        // Calls f(byte, child) for every child in byte order. The byte comes
+        // from this node's storage, so f can skip a child without loading it.
+        template<typename F>
+        void for_each_edge(F&& f) const {
+            kids.for_each_edge(f);
+        }
+
+        template<typename F>
+        void for_each_child(F&& f) const {
+            for_each_edge([&](unsigned char, TreeNode* child) { f(child); });
         }
 
-        void set_node(char c) {
-            next[c - 'a'] = new TreeNode();
+        // Child in slot pos or the first one after it, pos is left past it
+        TreeNode* child_after(int& pos) const {
+            return kids.child_after(pos);
         }
 
-        std::array<TreeNode*, 26> next{};
+        Kids kids;
         int cnt{};
         bool is_word{};
+
+        // Word nodes of this subtree with the highest cnt, best first
+        TreeNode* parent{};
+        char c{};
+        int top_size{};
+        std::array<TreeNode*, kTopK> top{};
     };
 
 public:
     PrefixTree()
     {
-        root_ = new TreeNode();
+        root_ = pool_.nodes.create();
     }
 
+    // Returns false, leaving the tree as it was, if word has a symbol
+    // outside the alphabet; always true for Alphabet::Bytes
     // N
     // Time : O(N)
     // Memory : O(N)
-    void insert(std::string_view word) {
+    bool insert(std::string_view word) {
+        if(!Traits::contains(word)) {
+            return false;
+        }
         TreeNode* curr = root_;
         for(int i = 0; i < word.size(); ++i) {
             char c = word[i];
             TreeNode* next = curr->get_node(c);
             if(next == nullptr) {
-                curr->set_node(c);
+                next = curr->set_node(c, pool_);
             }
-            curr = curr->get_node(c);
+            curr = next;
         }
 
         curr->is_word = true;
         ++(curr->cnt); 
+        promote(curr);
+        return true;
+    }
+
+    // Replaces the contents with words, which must be sorted in byte order
+    // (std::sort on std::string); repeats add to cnt. Each word only walks
+    // below its common prefix with the previous one, nodes come out of the
+    // pool in DFS order, and each top-K cache is filled once, when its node
+    // is finished, instead of on every insert. Unsorted input falls back to
+    // insert(). Words outside the alphabet are skipped, as by insert().
+    // S - total length of the words
+    // Time : O(S + nodes * kTopK)
+    // Memory : O(nodes)
+    template<typename Range>
+    void build_from_sorted(const Range& words) {
+        clear();
+        auto byte_less = [](const auto& a, const auto& b) { return std::string_view(a) < std::string_view(b); };
+        if(!std::is_sorted(std::begin(words), std::end(words), byte_less)) {
+            for(const auto& word : words) {
+                insert(word);
+            }
+            return;
+        }
+
+        // path[d] is the depth-d node of the previous word
+        std::vector<TreeNode*> path{root_};
+        std::string prev;
+        for(const auto& item : words) {
+            std::string_view word(item);
+            if(!Traits::contains(word)) {
+                continue;
+            }
+            std::size_t common = 0;
+            std::size_t limit = std::min(prev.size(), word.size());
+            while (common < limit && prev[common] == word[common])
+            {
+                ++common;
+            }
+
+            for(; path.size() > common + 1; path.pop_back()) {
+                finish(path.back());
+            }
+            for(std::size_t i = common; i < word.size(); ++i) {
+                path.push_back(path.back()->set_node(word[i], pool_));
+            }
+            path.back()->is_word = true;
+            ++(path.back()->cnt);
+            prev.assign(word);
+        }
+        for(; !path.empty(); path.pop_back()) {
+            finish(path.back());
+        }
     }
 
     // N
@@ -63,45 +519,828 @@ public:
         return curr->is_word;
     }
 
+    // Lazy pre-order walk yielding words in byte order. The view points
+    // into the iterator's own path buffer and stays valid until ++.
+    // Any insert invalidates the iterator.
+    class WordIterator {
+    public:
+        WordIterator() = default;
+
+        WordIterator(const TreeNode* start, std::string_view prefix)
+            : path_(prefix)
+        {
+            if(start == nullptr) {
+                return;
+            }
+            stack_.push_back({start, 0});
+            if(start->is_word) {
+                current_ = start;
+            } else {
+                advance();
+            }
+        }
+
+        std::string_view operator*() const {
+            return path_;
+        }
+
+        int count() const {
+            return current_->cnt;
+        }
+
+        WordIterator& operator++() {
+            advance();
+            return *this;
+        }
+
+        // Only compares against the end iterator
+        bool operator==(const WordIterator& o) const {
+            return current_ == o.current_;
+        }
+
+        bool operator!=(const WordIterator& o) const {
+            return current_ != o.current_;
+        }
+
+    private:
+        struct Frame {
+            const TreeNode* node;
+            int pos;
+        };
+
+        // Time : O(1) amortized per visited node
+        void advance() {
+            while (!stack_.empty())
+            {
+                Frame& top = stack_.back();
+                const TreeNode* child = top.node->child_after(top.pos);
+                if(child == nullptr) {
+                    stack_.pop_back();
+                    if(!stack_.empty()) {
+                        path_.pop_back();
+                    }
+                    continue;
+                }
+
+                path_.push_back(child->c);
+                stack_.push_back({child, 0});
+                if(child->is_word) {
+                    current_ = child;
+                    return;
+                }
+            }
+            current_ = nullptr;
+        }
+
+        std::string path_;
+        std::vector<Frame> stack_;
+        const TreeNode* current_{nullptr};
+    };
+
+    struct WordRange {
+        const TreeNode* start;
+        std::string_view prefix;
+
+        WordIterator begin() const { return WordIterator(start, prefix); }
+        WordIterator end() const { return WordIterator(); }
+    };
+
+    // Words starting with prefix, in byte order, produced one at a time:
+    // for(std::string_view w : tree.words("ca")) ...
+    // prefix must outlive the range
+    // Time : O(P) to start, then O(nodes walked)
+    WordRange words(std::string_view prefix = {}) const {
+        const TreeNode* curr = root_;
+        for(char c : prefix) {
+            curr = curr->get_node(c);
+            if(curr == nullptr) {
+                break;
+            }
+        }
+        return WordRange{curr, prefix};
+    }
+
     std::vector<std::string> get_all_words() {
         std::vector<std::string> ans;
-        std::string path;
-        dfs(root_, path, ans);
+        for(std::string_view w : words()) {
+            ans.emplace_back(w);
+        }
         return ans;
     }
 
+    // Frees every node in bulk
+    // Time : O(1) per slab
+    void clear() {
+        pool_.clear();
+        root_ = pool_.nodes.create();
+    }
+
     void erase(std::string_view word) {}
-    std::vector<std::string> prefix_find(std::string_view prefix) { 
-        // TODO 
-        return {}; 
+
+    // Node and block counts, bytes held by the pools and the fan-out
+    // (children per node) distribution, taken by one walk over the tree.
+    // Empty unless built with UFAR_STATS.
+    // Time : O(nodes)
+    StatsSnapshot stats_snapshot(const std::string& prefix = "prefix_tree") const {
+        StatsSnapshot ans;
+#if defined(UFAR_STATS)
+        Histogram fan_out;
+        std::uint64_t words = 0;
+        std::vector<const TreeNode*> stack{root_};
+        while (!stack.empty())
+        {
+            const TreeNode* node = stack.back();
+            stack.pop_back();
+            fan_out.add(node->kids.size);
+            words += node->is_word;
+            node->for_each_child([&](const TreeNode* child) { stack.push_back(child); });
+        }
+        ans.add(prefix + ".words", static_cast<double>(words));
+        ans.add(prefix + ".nodes", static_cast<double>(pool_.nodes.live()));
+        ans.add(prefix + ".small_blocks", static_cast<double>(pool_.small.live()));
+        ans.add(prefix + ".dense_blocks", static_cast<double>(pool_.dense.live()));
+        ans.add(prefix + ".bytes_live", static_cast<double>(pool_.nodes.live() * sizeof(TreeNode) +
+                                                            pool_.small.live() * sizeof(Small) +
+                                                            pool_.dense.live() * sizeof(Dense)));
+        ans.add(prefix + ".bytes_reserved", static_cast<double>(pool_.nodes.bytes_reserved() +
+                                                                pool_.small.bytes_reserved() +
+                                                                pool_.dense.bytes_reserved()));
+        ans.add(prefix + ".fan_out", fan_out);
+#endif
+        (void)prefix;
+        return ans;
+    }
+
+    // Writes the tree in the SnapshotLayout format for PrefixTreeSnapshot
+    // Time : O(nodes)
+    // Memory : O(file size)
+    bool freeze(const std::string& path) const {
+        std::vector<const TreeNode*> order{root_};
+        std::uint64_t words = 0;
+        for(std::size_t head = 0; head < order.size(); ++head) {
+            words += order[head]->is_word;
+            order[head]->for_each_child([&](const TreeNode* child) { order.push_back(child); });
+        }
+
+        SnapshotLayout layout(order.size(), words);
+        std::vector<std::uint64_t> image(layout.bytes / 8);
+        char* base = reinterpret_cast<char*>(image.data());
+        SnapshotLayout::Header header{SnapshotLayout::kMagic, layout.nodes, layout.words};
+        std::memcpy(base, &header, sizeof(header));
+
+        auto* louds = reinterpret_cast<std::uint64_t*>(base + layout.louds);
+        auto* zero_rank = reinterpret_cast<std::uint32_t*>(base + layout.zero_rank);
+        auto* samples = reinterpret_cast<std::uint32_t*>(base + layout.samples);
+        auto* terminal = reinterpret_cast<std::uint64_t*>(base + layout.terminal);
+        auto* terminal_rank = reinterpret_cast<std::uint32_t*>(base + layout.terminal_rank);
+        auto* labels = reinterpret_cast<unsigned char*>(base + layout.labels);
+        auto* counts = reinterpret_cast<std::uint32_t*>(base + layout.counts);
+        auto* max_counts = reinterpret_cast<std::uint32_t*>(base + layout.max_counts);
+
+        std::uint64_t bit = 0;
+        std::uint32_t zeros = 0;
+        std::uint32_t word = 0;
+        for(std::size_t v = 0; v < order.size(); ++v) {
+            const TreeNode* node = order[v];
+            bit += node->kids.size;
+            for(std::uint64_t b = bit - node->kids.size; b < bit; ++b) {
+                louds[b / 64] |= 1ULL << (b % 64);
+            }
+            if(zeros % SnapshotLayout::kSelectSample == 0) {
+                samples[zeros / SnapshotLayout::kSelectSample] = static_cast<std::uint32_t>(bit / 64);
+            }
+            ++zeros;
+            ++bit;
+
+            labels[v] = static_cast<unsigned char>(node->c);
+            max_counts[v] = node->top_size ? static_cast<std::uint32_t>(node->top[0]->cnt) : 0;
+            if(node->is_word) {
+                terminal[v / 64] |= 1ULL << (v % 64);
+                counts[word++] = static_cast<std::uint32_t>(node->cnt);
+            }
+        }
+
+        std::uint32_t ones = 0;
+        for(std::uint64_t w = 0; w < layout.terminal_words; ++w) {
+            terminal_rank[w] = ones;
+            ones += static_cast<std::uint32_t>(__builtin_popcountll(terminal[w]));
+        }
+        zeros = 0;
+        for(std::uint64_t w = 0; w < layout.louds_words; ++w) {
+            zero_rank[w] = zeros;
+            std::uint64_t used = std::min<std::uint64_t>(64, 2 * layout.nodes - 1 - w * 64);
+            zeros += static_cast<std::uint32_t>(used - __builtin_popcountll(louds[w]));
+        }
+        zero_rank[layout.louds_words] = zeros;
+
+        std::ofstream out(path, std::ios::binary);
+        out.write(base, static_cast<std::streamsize>(layout.bytes));
+        return static_cast<bool>(out);
+    }
+
+    // Up to k completions of prefix, most frequent first
+    // P - prefix length, L - word length
+    // Time : O(P + k * L) for k <= kTopK, O(P + subtree) above that
+    // Memory : O(k * L)
+    std::vector<std::string> prefix_find(std::string_view prefix, int k = kTopK) { 
+        TreeNode* curr = root_;
+        for(char c : prefix) {
+            curr = curr->get_node(c);
+            if(curr == nullptr) {
+                return {};
+            }
+        }
+
+        std::vector<TreeNode*> best;
+        if(k <= kTopK) {
+            best.assign(curr->top.begin(), curr->top.begin() + std::min(k, curr->top_size));
+        } else {
+            collect_words(curr, best);
+            auto by_cnt = [](const TreeNode* a, const TreeNode* b) { return a->cnt > b->cnt; };
+            std::size_t keep = std::min<std::size_t>(k, best.size());
+            std::partial_sort(best.begin(), best.begin() + keep, best.end(), by_cnt);
+            best.resize(keep);
+        }
+
+        std::vector<std::string> ans;
+        for(const TreeNode* node : best) {
+            ans.push_back(word_of(node));
+        }
+        return ans;
+    }
+
+    // Up to k words that start with something within max_edits edits
+    // (Levenshtein, per byte) of prefix, fewest edits first, then most frequent.
+    // The trie is walked with one DP row per depth and a branch is dropped
+    // as soon as every entry of its row exceeds max_edits.
+    // P - prefix length, E - max_edits
+    // Time : O(P * nodes within P + E bytes having a row <= E)
+    // Memory : O(P * (P + E))
+    std::vector<std::string> fuzzy_prefix_find(std::string_view prefix, int max_edits, int k = kTopK) {
+        // Entries above max_edits are stored as max_edits + 1, which never
+        // changes a decision and lets each row skip all but a 2E + 1 band
+        std::size_t width = prefix.size() + 1;
+        std::vector<int> rows((prefix.size() + max_edits + 2) * width, max_edits + 1);
+        for(std::size_t j = 0; j < width; ++j) {
+            rows[j] = std::min(static_cast<int>(j), max_edits + 1);
+        }
+
+        // (edits, node) for every node whose path is within max_edits of prefix
+        std::vector<std::pair<int, TreeNode*>> matches;
+        fuzzy_walk(root_, 0, 0, max_edits + 1, prefix, max_edits, rows, matches);
+
+        struct Candidate {
+            int edits;
+            int cnt;
+            TreeNode* word;
+        };
+        std::vector<Candidate> found;
+        for(auto [edits, node] : matches) {
+            if(k <= kTopK) {
+                for(int i = 0; i < node->top_size; ++i) {
+                    found.push_back({edits, node->top[i]->cnt, node->top[i]});
+                }
+            } else {
+                std::vector<TreeNode*> words;
+                collect_words(node, words);
+                for(TreeNode* word : words) {
+                    found.push_back({edits, word->cnt, word});
+                }
+            }
+        }
+
+        // A word reachable from several matches keeps its fewest edits
+        std::sort(found.begin(), found.end(), [](const Candidate& a, const Candidate& b) {
+            return a.word != b.word ? a.word < b.word : a.edits < b.edits;
+        });
+        found.erase(std::unique(found.begin(), found.end(),
+                                [](const Candidate& a, const Candidate& b) { return a.word == b.word; }),
+                    found.end());
+        std::size_t keep = std::min<std::size_t>(std::max(k, 0), found.size());
+        std::partial_sort(found.begin(), found.begin() + keep, found.end(), [](const Candidate& a, const Candidate& b) {
+            return a.edits != b.edits ? a.edits < b.edits : a.cnt > b.cnt;
+        });
+
+        std::vector<std::string> ans;
+        for(std::size_t i = 0; i < keep; ++i) {
+            ans.push_back(word_of(found[i].word));
+        }
+        return ans;
     }
 
 private:
-    // K
-    // O(K) > O(L)
-    void dfs(TreeNode* root, std::string& path, std::vector<std::string>& ans) {
-        if(root == nullptr){
-            return;
+    // rows[depth] holds the edit distances from the path of node to every
+    // prefix of the query, best is its minimum. Nodes below can only do
+    // worse than best, and covered is the best match among the ancestors,
+    // whose subtree already holds their words. A child's row is computed
+    // from the edge byte and checked before the child itself is touched.
+    void fuzzy_walk(TreeNode* node, int depth, int best, int covered, std::string_view prefix, int max_edits,
+                    std::vector<int>& rows, std::vector<std::pair<int, TreeNode*>>& matches) {
+        std::size_t width = prefix.size() + 1;
+        const int* row = rows.data() + depth * width;
+        if(row[prefix.size()] < covered) {
+            covered = row[prefix.size()];
+            matches.push_back({covered, node});
+            if(covered == best) {
+                return;
+            }
         }
 
-        for(int i = 0; i < 26; ++i) {
-            auto child = root->next[i];
-            if(child){
-                char c = static_cast<char>('a' + i);
-                path.push_back(c);
-                if(child->is_word) {
-                    ans.push_back(path);
+        // Only |depth - j| <= max_edits can stay within the bound
+        int* next = rows.data() + (depth + 1) * width;
+        int lo = std::max(0, depth + 1 - max_edits);
+        int hi = std::min(static_cast<int>(prefix.size()), depth + 1 + max_edits);
+        node->for_each_edge([&](unsigned char c, TreeNode* child) {
+            int next_best = max_edits + 1;
+            for(int j = lo; j <= hi; ++j) {
+                int value = row[j] + 1;
+                if(j > 0) {
+                    int replace = row[j - 1] + (static_cast<unsigned char>(prefix[j - 1]) != c);
+                    value = std::min({value, replace, next[j - 1] + 1});
                 }
-                dfs(root->next[i], path, ans);
-                path.pop_back();
+                next[j] = std::min(value, max_edits + 1);
+                next_best = std::min(next_best, next[j]);
+            }
+            if(next_best <= max_edits && next_best < covered) {
+                fuzzy_walk(child, depth + 1, next_best, covered, prefix, max_edits, rows, matches);
+            }
+        });
+    }
+
+    // cnt of word only grew, so it can only move up in each ancestor's cache.
+    // Once it fails to enter one, it cannot enter any higher one either:
+    // that node's kTopK better words are in every ancestor's subtree.
+    // Time : O(L * kTopK)
+    void promote(TreeNode* word) {
+        for(TreeNode* node = word; node != nullptr; node = node->parent) {
+            auto& top = node->top;
+            int i = static_cast<int>(std::find(top.begin(), top.begin() + node->top_size, word) - top.begin());
+            if(i == node->top_size) {
+                if(node->top_size < kTopK) {
+                    ++node->top_size;
+                } else if(top[kTopK - 1]->cnt < word->cnt) {
+                    i = kTopK - 1;
+                } else {
+                    return;
+                }
+                top[i] = word;
+            }
+
+            while (i > 0 && top[i - 1]->cnt < top[i]->cnt)
+            {
+                std::swap(top[i - 1], top[i]);
+                --i;
             }
         }
     }
 
+    // Subtree of node is complete: node joins its own cache, which then
+    // already holds the best of every child, and the cache is offered up
+    // Time : O(kTopK^2)
+    void finish(TreeNode* node) {
+        if(node->is_word) {
+            offer(node, node);
+        }
+        if(node->parent) {
+            for(int i = 0; i < node->top_size; ++i) {
+                offer(node->parent, node->top[i]);
+            }
+        }
+    }
+
+    // Keeps the kTopK most frequent offers, earlier ones win ties
+    void offer(TreeNode* node, TreeNode* word) {
+        auto& top = node->top;
+        int i = node->top_size;
+        if(i == kTopK) {
+            if(top[kTopK - 1]->cnt >= word->cnt) {
+                return;
+            }
+            --i;
+        } else {
+            ++node->top_size;
+        }
+        top[i] = word;
+
+        while (i > 0 && top[i - 1]->cnt < top[i]->cnt)
+        {
+            std::swap(top[i - 1], top[i]);
+            --i;
+        }
+    }
+
+    // Time : O(L)
+    std::string word_of(const TreeNode* node) const {
+        std::string word;
+        for(; node != root_; node = node->parent) {
+            word.push_back(node->c);
+        }
+        std::reverse(word.begin(), word.end());
+        return word;
+    }
+
+    void collect_words(TreeNode* root, std::vector<TreeNode*>& ans) {
+        if(root->is_word) {
+            ans.push_back(root);
+        }
+        root->for_each_child([&](TreeNode* child) { collect_words(child, ans); });
+    }
 
+    Pools pool_;
     TreeNode* root_;
 };
 
+// Read-only PrefixTree answering straight from an mmap-ed freeze() file.
+// Processes mapping the same file share its pages.
+class PrefixTreeSnapshot {
+public:
+    PrefixTreeSnapshot() = default;
+
+    // Checks the header and size, then with verify every section against
+    // the others (see valid()), so a corrupt file fails here instead of
+    // reading past the mapping in a query. verify = false skips that pass
+    // and keeps startup independent of the word count, for files this
+    // program froze itself.
+    // Time : O(file size), O(1) without verify
+    bool open(const std::string& path, bool verify = true) {
+        close();
+        if(!file_.open(path) || file_.size() < sizeof(SnapshotLayout::Header)) {
+            close();
+            return false;
+        }
+
+        // Every node takes a label byte, which bounds the counts before
+        // the layout arithmetic can overflow
+        SnapshotLayout::Header header;
+        std::memcpy(&header, file_.data(), sizeof(header));
+        if(header.magic != SnapshotLayout::kMagic || header.nodes == 0 ||
+           header.nodes > file_.size() || header.words > header.nodes ||
+           SnapshotLayout(header.nodes, header.words).bytes != file_.size()) {
+            close();
+            return false;
+        }
+
+        SnapshotLayout layout(header.nodes, header.words);
+        nodes_ = layout.nodes;
+        words_ = layout.words;
+        louds_ = section<std::uint64_t>(layout.louds);
+        zero_rank_ = section<std::uint32_t>(layout.zero_rank);
+        samples_ = section<std::uint32_t>(layout.samples);
+        terminal_ = section<std::uint64_t>(layout.terminal);
+        terminal_rank_ = section<std::uint32_t>(layout.terminal_rank);
+        labels_ = section<unsigned char>(layout.labels);
+        counts_ = section<std::uint32_t>(layout.counts);
+        max_counts_ = section<std::uint32_t>(layout.max_counts);
+        if(verify && !valid(layout)) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void close() {
+        file_.close();
+        nodes_ = 0;
+        words_ = 0;
+    }
+
+    std::uint64_t word_count() const {
+        return words_;
+    }
+
+    // N
+    // Time : O(N log sigma)
+    bool find(std::string_view word) const {
+        std::int64_t v = walk(word);
+        return v >= 0 && is_word(v);
+    }
+
+    // Best-first search on the subtree maxima: a subtree is opened only when
+    // its best word can still make the top k.
+    // Time : O(P log sigma + k * L * fan-out * log)
+    std::vector<std::string> prefix_find(std::string_view prefix, int k = PrefixTree<>::kTopK) const {
+        std::vector<std::string> ans;
+        std::int64_t start = walk(prefix);
+        if(start < 0 || k <= 0) {
+            return ans;
+        }
+
+        // Path of every queued node as (parent entry, byte), shared by siblings
+        struct Entry {
+            int parent;
+            unsigned char c;
+        };
+        struct Item {
+            std::uint32_t key;
+            std::uint64_t node;
+            int entry;
+            bool emit;
+
+            // On equal keys finished words go first, then deeper nodes,
+            // so ties dive to a word instead of widening the frontier
+            bool operator<(const Item& o) const {
+                if(key != o.key) {
+                    return key < o.key;
+                }
+                return emit != o.emit ? o.emit : node < o.node;
+            }
+        };
+        std::vector<Entry> entries{{-1, 0}};
+        std::priority_queue<Item> queue;
+        queue.push({max_counts_[start], static_cast<std::uint64_t>(start), 0, false});
+
+        while (!queue.empty() && static_cast<int>(ans.size()) < k)
+        {
+            Item item = queue.top();
+            queue.pop();
+            if(item.emit) {
+                std::string word(prefix);
+                std::size_t tail = word.size();
+                for(int e = item.entry; e > 0; e = entries[e].parent) {
+                    word.push_back(static_cast<char>(entries[e].c));
+                }
+                std::reverse(word.begin() + tail, word.end());
+                ans.push_back(std::move(word));
+                continue;
+            }
+
+            if(is_word(item.node)) {
+                queue.push({count(item.node), item.node, item.entry, true});
+            }
+            auto [first, last] = children(item.node);
+            for(std::uint64_t child = first; child < last; ++child) {
+                entries.push_back({item.entry, labels_[child]});
+                queue.push({max_counts_[child], child, static_cast<int>(entries.size()) - 1, false});
+            }
+        }
+        return ans;
+    }
+
+private:
+    template<typename T>
+    const T* section(std::size_t offset) const {
+        return reinterpret_cast<const T*>(file_.data() + offset);
+    }
+
+    // What the queries rely on, recomputed from the bits and compared:
+    //   louds      2N - 1 bits holding N zeros, zero padding after them;
+    //              every node's children come after it in BFS order (the
+    //              ones seen before a node's block can number it), so
+    //              walks stay in [0, N) and terminate
+    //   zero_rank  the zeros before every louds word, ending at N
+    //   samples    the louds word of every kSelectSample-th zero
+    //   terminal   W set bits below N, terminal_rank their prefix counts
+    //   labels     strictly increasing among siblings, for lower_bound
+    // Time : O(file size)
+    bool valid(const SnapshotLayout& layout) const {
+        const std::uint64_t bits = 2 * nodes_ - 1;
+        std::uint64_t zeros = 0;
+        std::uint64_t ones = 0;
+        std::uint64_t block_start = 0;
+        for(std::uint64_t w = 0; w < layout.louds_words; ++w) {
+            if(zero_rank_[w] != zeros) {
+                return false;
+            }
+            std::uint64_t used = std::min<std::uint64_t>(64, bits - w * 64);
+            if(used < 64 && (louds_[w] >> used) != 0) {
+                return false;
+            }
+            for(std::uint64_t b = 0; b < used; ++b) {
+                if((louds_[w] >> b) & 1) {
+                    ++ones;
+                    continue;
+                }
+                // This zero closes node `zeros` and its children
+                // ones_before_block + 1 .. ones
+                if(zeros % SnapshotLayout::kSelectSample == 0 &&
+                   samples_[zeros / SnapshotLayout::kSelectSample] != w) {
+                    return false;
+                }
+                for(std::uint64_t child = block_start + 2; child <= ones; ++child) {
+                    if(labels_[child - 1] >= labels_[child]) {
+                        return false;
+                    }
+                }
+                ++zeros;
+                if(zeros < nodes_ && ones < zeros) {
+                    return false;
+                }
+                block_start = ones;
+            }
+        }
+        if(zeros != nodes_ || ones != nodes_ - 1 || zero_rank_[layout.louds_words] != zeros) {
+            return false;
+        }
+
+        std::uint64_t words = 0;
+        for(std::uint64_t w = 0; w < layout.terminal_words; ++w) {
+            if(terminal_rank_[w] != words) {
+                return false;
+            }
+            std::uint64_t used = std::min<std::uint64_t>(64, nodes_ - w * 64);
+            if(used < 64 && (terminal_[w] >> used) != 0) {
+                return false;
+            }
+            words += __builtin_popcountll(terminal_[w]);
+        }
+        return words == words_;
+    }
+
+    // Position of the j-th 0 in louds, j counted from 0
+    // Time : O(1) expected, a short scan from the sampled word
+    std::uint64_t select0(std::uint64_t j) const {
+        std::uint64_t w = samples_[j / SnapshotLayout::kSelectSample];
+        while (zero_rank_[w + 1] <= j)
+        {
+            ++w;
+        }
+        std::uint64_t free_bits = ~louds_[w];
+        for(std::uint64_t r = j - zero_rank_[w]; r > 0; --r) {
+            free_bits &= free_bits - 1;
+        }
+        return w * 64 + __builtin_ctzll(free_bits);
+    }
+
+    // Children of v as the node range [first, last)
+    std::pair<std::uint64_t, std::uint64_t> children(std::uint64_t v) const {
+        std::uint64_t begin = v == 0 ? 0 : select0(v - 1) + 1;
+        std::uint64_t end = select0(v);
+        return {begin - v + 1, end - v + 1};
+    }
+
+    std::int64_t walk(std::string_view word) const {
+        if(nodes_ == 0) {
+            return -1;
+        }
+        std::uint64_t v = 0;
+        for(char ch : word) {
+            auto [first, last] = children(v);
+            const unsigned char* it = std::lower_bound(labels_ + first, labels_ + last, static_cast<unsigned char>(ch));
+            if(it == labels_ + last || *it != static_cast<unsigned char>(ch)) {
+                return -1;
+            }
+            v = static_cast<std::uint64_t>(it - labels_);
+        }
+        return static_cast<std::int64_t>(v);
+    }
+
+    bool is_word(std::uint64_t v) const {
+        return (terminal_[v / 64] >> (v % 64)) & 1;
+    }
+
+    std::uint32_t count(std::uint64_t v) const {
+        std::uint64_t below = terminal_[v / 64] & ((1ULL << (v % 64)) - 1);
+        return counts_[terminal_rank_[v / 64] + __builtin_popcountll(below)];
+    }
+
+    MappedFile file_;
+    std::uint64_t nodes_{0};
+    std::uint64_t words_{0};
+    const std::uint64_t* louds_{nullptr};
+    const std::uint32_t* zero_rank_{nullptr};
+    const std::uint32_t* samples_{nullptr};
+    const std::uint64_t* terminal_{nullptr};
+    const std::uint32_t* terminal_rank_{nullptr};
+    const unsigned char* labels_{nullptr};
+    const std::uint32_t* counts_{nullptr};
+    const std::uint32_t* max_counts_{nullptr};
+};
+
+// Path-compressed (radix / Patricia) trie over arbitrary bytes.
+// A chain of single-child nodes is merged into one node whose label holds the
+// whole run, so there is one node per branching point instead of one per
+// character, and children are a short vector sorted by first byte instead
+// of 26 mostly-null pointers. Labels up to 15 bytes fit in the std::string
+// without a heap allocation.
+class RadixTree {
+    struct TreeNode {
+        TreeNode* get_node(unsigned char c) const {
+            auto it = lower_bound(c);
+            return it != next.end() && first_byte(*it) == c ? *it : nullptr;
+        }
+
+        std::vector<TreeNode*>::const_iterator lower_bound(unsigned char c) const {
+            return std::lower_bound(next.begin(), next.end(), c,
+                                    [](const TreeNode* n, unsigned char b) { return first_byte(n) < b; });
+        }
+
+        static unsigned char first_byte(const TreeNode* n) {
+            return static_cast<unsigned char>(n->label[0]);
+        }
+
+        std::string label;
+        std::vector<TreeNode*> next;
+        int cnt{};
+        bool is_word{};
+    };
+
+public:
+    RadixTree()
+    {
+        root_ = pool_.create();
+    }
+
+    RadixTree(const RadixTree&) = delete;
+    RadixTree& operator=(const RadixTree&) = delete;
+
+    ~RadixTree() {
+        destroy(root_);
+    }
+
+    // N
+    // Time : O(N) plus O(children) to place a new child
+    // Memory : O(1), at most two new nodes
+    void insert(std::string_view word) {
+        TreeNode* curr = root_;
+        while (!word.empty())
+        {
+            unsigned char c = static_cast<unsigned char>(word[0]);
+            auto it = curr->lower_bound(c);
+            if(it == curr->next.end() || TreeNode::first_byte(*it) != c) {
+                TreeNode* leaf = pool_.create();
+                leaf->label.assign(word);
+                curr->next.insert(it, leaf);
+                curr = leaf;
+                break;
+            }
+
+            TreeNode* child = *it;
+            std::size_t common = 0;
+            std::size_t limit = std::min(child->label.size(), word.size());
+            while (common < limit && child->label[common] == word[common]) {
+                ++common;
+            }
+
+            if(common < child->label.size()) {
+                // Split child: the shared part becomes a new parent
+                TreeNode* mid = pool_.create();
+                mid->label.assign(child->label, 0, common);
+                child->label.erase(0, common);
+                mid->next.push_back(child);
+                curr->next[it - curr->next.begin()] = mid;
+                child = mid;
+            }
+
+            curr = child;
+            word.remove_prefix(common);
+        }
+
+        curr->is_word = true;
+        ++(curr->cnt);
+    }
+
+    // N
+    // Time : O(N)
+    // Memory : O(1)
+    bool find(std::string_view word) const {
+        const TreeNode* curr = root_;
+        while (!word.empty())
+        {
+            curr = curr->get_node(static_cast<unsigned char>(word[0]));
+            if(curr == nullptr || word.compare(0, curr->label.size(), curr->label) != 0) {
+                return false;
+            }
+            word.remove_prefix(curr->label.size());
+        }
+        return curr->is_word;
+    }
+
+    std::vector<std::string> get_all_words() const {
+        std::vector<std::string> ans;
+        std::string path;
+        dfs(root_, path, ans);
+        return ans;
+    }
+
+    std::size_t node_count() const {
+        return pool_.live();
+    }
+
+private:
+    void dfs(const TreeNode* root, std::string& path, std::vector<std::string>& ans) const {
+        for(const TreeNode* child : root->next) {
+            path += child->label;
+            if(child->is_word) {
+                ans.push_back(path);
+            }
+            dfs(child, path, ans);
+            path.resize(path.size() - child->label.size());
+        }
+    }
+
+    void destroy(TreeNode* root) {
+        for(TreeNode* child : root->next) {
+            destroy(child);
+        }
+        root->~TreeNode();
+    }
+
+    NodePool<TreeNode> pool_;
+    TreeNode* root_;
+};
+
+// Define UFAR_NO_MAIN to include this file from a benchmark or another driver
+#ifndef UFAR_NO_MAIN
 int main() {
     PrefixTree tree;
     tree.insert("abc");
@@ -121,4 +1360,101 @@ int main() {
     for(auto& w : all) {
         std::cout << w << ", ";
     }
+    std::cout << std::endl;
+
+    tree.clear();
+    std::cout << tree.find("abc") << " " << tree.get_all_words().size() << std::endl;
+
+    std::cout << "--------------------------" << std::endl;
+
+    for(const char* w : {"car", "card", "care", "careful", "cart", "cat", "car", "cart", "care", "car", "dog"}) {
+        tree.insert(w);
+    }
+    for(auto& w : tree.prefix_find("car")) {
+        std::cout << w << ", ";
+    }
+    std::cout << std::endl;
+    for(auto& w : tree.prefix_find("ca", 2)) {
+        std::cout << w << ", ";
+    }
+    std::cout << std::endl;
+
+    std::cout << "--------------------------" << std::endl;
+
+    for(const char* w : {"Zürich", "Zug", "zoo", "Zürich", "Z-42", "Zoë", "Zürichsee", "Z 9"}) {
+        tree.insert(w);
+    }
+    std::cout << tree.find("Zürich") << " " << tree.find("zürich") << " " << tree.find("Z-42") << std::endl;
+    for(auto& w : tree.prefix_find("Z")) {
+        std::cout << w << ", ";
+    }
+    std::cout << std::endl;
+
+    std::cout << "--------------------------" << std::endl;
+
+    int shown = 0;
+    for(std::string_view w : tree.words("Z")) {
+        if(++shown > 3) {
+            break;
+        }
+        std::cout << w << ", ";
+    }
+    std::cout << std::endl;
+
+    std::cout << "--------------------------" << std::endl;
+
+    for(auto& w : tree.fuzzy_prefix_find("cra", 1)) {
+        std::cout << w << ", ";
+    }
+    std::cout << std::endl;
+
+    std::vector<std::string> sorted{"apple", "apple", "applet", "apply", "banana", "band", "bandana"};
+    PrefixTree bulk;
+    bulk.build_from_sorted(sorted);
+    for(auto& w : bulk.prefix_find("app")) {
+        std::cout << w << ", ";
+    }
+    std::cout << bulk.find("band") << std::endl;
+
+    std::cout << "--------------------------" << std::endl;
+
+    // The snapshot goes to the temp directory and is removed afterwards
+    const std::string trie_path = (std::filesystem::temp_directory_path() / "ufar_words.trie").string();
+    tree.freeze(trie_path);
+    PrefixTreeSnapshot snapshot;
+    if(snapshot.open(trie_path)) {
+        std::cout << snapshot.word_count() << " words, " << snapshot.find("careful") << " " << snapshot.find("Zür") << std::endl;
+        for(auto& w : snapshot.prefix_find("car")) {
+            std::cout << w << ", ";
+        }
+        std::cout << std::endl;
+        snapshot.close();
+    }
+    std::filesystem::remove(trie_path);
+
+    std::cout << "--------------------------" << std::endl;
+
+    PrefixTree<Alphabet::Digits> phones;
+    for(const char* p : {"0441234567", "0449876543", "0441234567", "0791112233", "044-123", "+41791112233"}) {
+        std::cout << phones.insert(p);
+    }
+    std::cout << " " << phones.find("0791112233") << " " << phones.find("044") << std::endl;
+    for(auto& w : phones.prefix_find("044")) {
+        std::cout << w << ", ";
+    }
+    std::cout << std::endl;
+
+    std::cout << "--------------------------" << std::endl;
+
+    RadixTree radix;
+    for(const char* w : {"romane", "romanus", "romulus", "rubens", "ruber", "rubicon", "rubicundus", "Rome 2"}) {
+        radix.insert(w);
+    }
+    std::cout << radix.find("ruber") << " " << radix.find("rub") << " " << radix.find("Rome 2") << std::endl;
+    std::cout << radix.node_count() << " nodes" << std::endl;
+    for(auto& w : radix.get_all_words()) {
+        std::cout << w << ", ";
+    }
+    std::cout << std::endl;
 }
+#endif
@@ -0,0 +1,180 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <ios>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Hot-path counters are compiled in only with -DUFAR_STATS. Without it every
+// UFAR_STAT(...) expands to nothing and the counter members do not exist, so
+// a normal build pays neither time nor memory. The stats_snapshot() methods
+// exist in both builds and return an empty snapshot when counters are off,
+// so exporters need no #ifdef.
+//
+// Counters are plain, non-atomic integers owned by one structure or one
+// query context. A stats build keeps the threading rules of a normal build
+// except where a const lookup records into its structure: FlatHashTable's
+// probe histogram is written by find(), so concurrent readers of one table
+// are a data race in stats builds. Profile shared tables single-threaded.
+#if defined(UFAR_STATS)
+#define UFAR_STAT(...) __VA_ARGS__
+#else
+#define UFAR_STAT(...)
+#endif
+
+// Counts of small non-negative values such as probe or chain lengths.
+// Values 0 .. kBuckets - 2 get a bucket each, larger ones share the last.
+class Histogram {
+public:
+    static constexpr int kBuckets = 32;
+
+    // Time - O(1)
+    void add(std::uint64_t value) {
+        ++buckets_[std::min<std::uint64_t>(value, kBuckets - 1)];
+        ++count_;
+        sum_ += value;
+        max_ = std::max(max_, value);
+    }
+
+    void merge(const Histogram& other) {
+        for(int i = 0; i < kBuckets; ++i) {
+            buckets_[i] += other.buckets_[i];
+        }
+        count_ += other.count_;
+        sum_ += other.sum_;
+        max_ = std::max(max_, other.max_);
+    }
+
+    void clear() {
+        *this = Histogram();
+    }
+
+    std::uint64_t count() const {
+        return count_;
+    }
+
+    std::uint64_t max() const {
+        return max_;
+    }
+
+    double mean() const {
+        return count_ == 0 ? 0 : static_cast<double>(sum_) / count_;
+    }
+
+    std::uint64_t bucket(int i) const {
+        return buckets_[i];
+    }
+
+    // Smallest value v with at least q of the samples <= v
+    // Time - O(kBuckets)
+    std::uint64_t quantile(double q) const {
+        std::uint64_t seen = 0;
+        for(int i = 0; i < kBuckets - 1; ++i) {
+            seen += buckets_[i];
+            if(seen > 0 && seen >= q * count_) {
+                return i;
+            }
+        }
+        return max_;
+    }
+
+private:
+    std::array<std::uint64_t, kBuckets> buckets_{};
+    std::uint64_t count_{0};
+    std::uint64_t sum_{0};
+    std::uint64_t max_{0};
+};
+
+// Adds the time until it goes out of scope to a nanosecond counter
+class StatsTimer {
+public:
+    explicit StatsTimer(std::uint64_t& total)
+        : total_(total)
+        , start_(std::chrono::steady_clock::now())
+    {}
+
+    StatsTimer(const StatsTimer&) = delete;
+    StatsTimer& operator=(const StatsTimer&) = delete;
+
+    ~StatsTimer() {
+        auto elapsed = std::chrono::steady_clock::now() - start_;
+        total_ += std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+    }
+
+private:
+    std::uint64_t& total_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+// Flat list of dotted metric names and values, the shape metrics pipelines
+// ingest. A histogram becomes count, mean, p50, p99, max and one entry per
+// non-empty bucket.
+class StatsSnapshot {
+public:
+    using Metric = std::pair<std::string, double>;
+
+    void add(std::string name, double value) {
+        metrics_.emplace_back(std::move(name), value);
+    }
+
+    void add(const std::string& name, const Histogram& histogram) {
+        add(name + ".count", static_cast<double>(histogram.count()));
+        add(name + ".mean", histogram.mean());
+        add(name + ".p50", static_cast<double>(histogram.quantile(0.5)));
+        add(name + ".p99", static_cast<double>(histogram.quantile(0.99)));
+        add(name + ".max", static_cast<double>(histogram.max()));
+        for(int i = 0; i < Histogram::kBuckets; ++i) {
+            if(histogram.bucket(i) != 0) {
+                std::string bucket = i + 1 < Histogram::kBuckets ? std::to_string(i) : "overflow";
+                add(name + ".bucket." + bucket, static_cast<double>(histogram.bucket(i)));
+            }
+        }
+    }
+
+    // Appends another snapshot, e.g. to export several structures at once
+    void add(const StatsSnapshot& other) {
+        metrics_.insert(metrics_.end(), other.metrics_.begin(), other.metrics_.end());
+    }
+
+    bool empty() const {
+        return metrics_.empty();
+    }
+
+    const std::vector<Metric>& metrics() const {
+        return metrics_;
+    }
+
+    // One JSON object, {"name": value, ...}; names are plain identifiers and
+    // dots. Counters are written as exact integers and other values with
+    // 17 significant digits, enough to round-trip a double, and inf or NaN
+    // as null. The stream's formatting is restored afterwards.
+    void write_json(std::ostream& out) const {
+        std::ios_base::fmtflags flags = out.flags();
+        std::streamsize precision = out.precision();
+        out << '{';
+        for(std::size_t i = 0; i < metrics_.size(); ++i) {
+            out << (i == 0 ? "" : ", ") << '"' << metrics_[i].first << "\": ";
+            double value = metrics_[i].second;
+            if(!std::isfinite(value)) {
+                out << "null";
+            } else if(value == std::floor(value) && std::fabs(value) < 9.007199254740992e15) {
+                out << static_cast<long long>(value);
+            } else {
+                out << std::defaultfloat << std::setprecision(17) << value;
+            }
+        }
+        out << '}';
+        out.flags(flags);
+        out.precision(precision);
+    }
+
+private:
+    std::vector<Metric> metrics_;
+};
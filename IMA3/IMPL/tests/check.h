@@ -0,0 +1,18 @@
+#pragma once
+
+#include <iostream>
+
+// Minimal checks for the ctest drivers: a failed CHECK prints where and
+// what, the test keeps going, and main() returns the failure count.
+inline int& CheckFailures() {
+    static int failures = 0;
+    return failures;
+}
+
+#define CHECK(cond)                                                                 \
+    do {                                                                            \
+        if(!(cond)) {                                                               \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK(" #cond ") failed\n"; \
+            ++CheckFailures();                                                      \
+        }                                                                           \
+    } while (0)
@@ -0,0 +1,43 @@
+// Loaders in graph_2.cpp on edge cases of their input files
+
+#include "check.h"
+#include "../graph_2.cpp"
+
+#include <filesystem>
+
+void WriteText(const std::string& path, const std::string& text) {
+    std::ofstream out(path, std::ios::binary);
+    out << text;
+}
+
+void TestWeightedEdgeList(const std::string& path) {
+    WeightedCsrGraph graph;
+    WriteText(path, "from,to,minutes\n1,2,5\n2,3,0\n");
+    CHECK(LoadWeightedEdgeList(path, graph));
+    CHECK(graph.vertex_count() == 3);
+
+    WriteText(path, "1,2,5\n2,3,-4\n3,4,1\n");
+    CHECK(!LoadWeightedEdgeList(path, graph));
+    CHECK(graph.vertex_count() == 0);
+}
+
+// An empty graph saves ids and neighbours as zero-length arrays
+void TestEmptyCsrRoundTrip(const std::string& path) {
+    CsrGraph graph;
+    CHECK(LoadEdgeList(path, graph));
+    CHECK(SaveCsrGraph(graph, path));
+    CsrGraph loaded;
+    CHECK(LoadCsrGraph(path, loaded));
+    CHECK(loaded.vertex_count() == 0);
+    CHECK(loaded.edge_count() == 0);
+}
+
+int main() {
+    const std::filesystem::path tmp = std::filesystem::temp_directory_path();
+    const std::string text_path = (tmp / "ufar_test_edges.csv").string();
+    TestWeightedEdgeList(text_path);
+    WriteText(text_path, "# no edges\n");
+    TestEmptyCsrRoundTrip(text_path);
+    std::filesystem::remove(text_path);
+    return CheckFailures();
+}
@@ -0,0 +1,70 @@
+// Hash policy quality and HashTable chain lengths on adversarial integer
+// key patterns. Built with UFAR_STATS for the chain-length histogram.
+
+#include "check.h"
+#include "../hash_table.cpp"
+
+#include <algorithm>
+#include <random>
+
+// Longest bucket when n keys key(0..n-1) are masked into 2n buckets
+template<typename KeyAt>
+int LongestBucket(int log2_buckets, KeyAt key) {
+    const std::size_t buckets = std::size_t{1} << log2_buckets;
+    std::vector<int> count(buckets, 0);
+    DefaultHash<std::int64_t> hash;
+    for(std::size_t i = 0; i < buckets / 2; ++i) {
+        ++count[hash(key(i)) & (buckets - 1)];
+    }
+    return *std::max_element(count.begin(), count.end());
+}
+
+// At load 0.5 random keys give a longest bucket of about 6-8 in these
+// tables; the bound leaves room for that and rejects the 11-15 of a
+// policy whose low bits do not mix
+constexpr int kMaxBucket = 9;
+
+void TestPolicyOnPatterns() {
+    std::mt19937_64 rng(7);
+    for(int log2_buckets : {17, 20}) {
+        for(std::int64_t stride : {1, 3, 16, 1024, 4097}) {
+            CHECK(LongestBucket(log2_buckets, [&](std::size_t i) { return static_cast<std::int64_t>(i) * stride; }) <= kMaxBucket);
+        }
+        CHECK(LongestBucket(log2_buckets, [](std::size_t i) { return -static_cast<std::int64_t>(i); }) <= kMaxBucket);
+        // Packed pairs: the high half varies slowly, the low half fast
+        CHECK(LongestBucket(log2_buckets, [](std::size_t i) {
+            return static_cast<std::int64_t>(((i % 1000) << 32) | (i / 1000));
+        }) <= kMaxBucket);
+        CHECK(LongestBucket(log2_buckets, [](std::size_t i) { return static_cast<std::int64_t>(i << 32); }) <= kMaxBucket);
+        CHECK(LongestBucket(log2_buckets, [&](std::size_t) { return static_cast<std::int64_t>(rng()); }) <= kMaxBucket);
+    }
+}
+
+double Metric(const StatsSnapshot& snapshot, const std::string& name) {
+    for(const StatsSnapshot::Metric& metric : snapshot.metrics()) {
+        if(metric.first == name) {
+            return metric.second;
+        }
+    }
+    return -1;
+}
+
+// Longest chain any insert walked, through the table itself
+void TestTableChains() {
+    for(std::int64_t stride : {1, 3, 1024}) {
+        HashTable<std::int64_t> table(16);
+        for(std::int64_t i = 0; i < 1 << 17; ++i) {
+            table.insert(i * stride);
+        }
+        StatsSnapshot stats = table.stats_snapshot();
+        CHECK(Metric(stats, "hash_table.chain_length.max") >= 0);
+        CHECK(Metric(stats, "hash_table.chain_length.max") <= kMaxBucket);
+        CHECK(table.size() == 1 << 17);
+    }
+}
+
+int main() {
+    TestPolicyOnPatterns();
+    TestTableChains();
+    return CheckFailures();
+}
@@ -0,0 +1,119 @@
+// PrefixTreeSnapshot::open against corrupted freeze() files: targeted
+// damage to every section must be rejected, and random damage must either
+// be rejected or leave a snapshot whose queries stay inside the mapping.
+
+#include "check.h"
+#include "../prefix_tree.cpp"
+
+#include <filesystem>
+#include <random>
+
+std::string ReadFile(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), {});
+}
+
+void WriteFile(const std::string& path, const std::string& bytes) {
+    std::ofstream out(path, std::ios::binary);
+    out << bytes;
+}
+
+template<typename T>
+void Poke(std::string& bytes, std::size_t offset, T value) {
+    std::memcpy(&bytes[offset], &value, sizeof(T));
+}
+
+template<typename T>
+T Peek(const std::string& bytes, std::size_t offset) {
+    T value;
+    std::memcpy(&value, &bytes[offset], sizeof(T));
+    return value;
+}
+
+bool Opens(const std::string& path, const std::string& bytes) {
+    WriteFile(path, bytes);
+    PrefixTreeSnapshot snapshot;
+    return snapshot.open(path);
+}
+
+int main() {
+    PrefixTree tree;
+    std::mt19937 rng(11);
+    std::vector<std::string> words;
+    for(int i = 0; i < 3000; ++i) {
+        std::string word;
+        for(int length = 1 + rng() % 10; length > 0; --length) {
+            word += static_cast<char>('a' + rng() % 6);
+        }
+        tree.insert(word);
+        words.push_back(word);
+    }
+
+    const std::filesystem::path tmp = std::filesystem::temp_directory_path();
+    const std::string good_path = (tmp / "ufar_test_good.trie").string();
+    const std::string bad_path = (tmp / "ufar_test_bad.trie").string();
+    CHECK(tree.freeze(good_path));
+    const std::string good = ReadFile(good_path);
+    CHECK(Opens(bad_path, good));
+
+    SnapshotLayout::Header header;
+    std::memcpy(&header, good.data(), sizeof(header));
+    SnapshotLayout layout(header.nodes, header.words);
+
+    // One targeted defect per section
+    std::vector<std::string> damaged;
+    auto damage = [&](auto edit) {
+        std::string bytes = good;
+        edit(bytes);
+        damaged.push_back(bytes);
+    };
+    damage([&](std::string& b) { b.resize(b.size() - 8); });
+    damage([&](std::string& b) { Poke<std::uint64_t>(b, 8, header.nodes * 1000); });
+    damage([&](std::string& b) { Poke<std::uint64_t>(b, 8, ~0ULL / 2); });
+    damage([&](std::string& b) { Poke<std::uint64_t>(b, 16, header.words + 1); });
+    damage([&](std::string& b) { b[layout.louds] ^= 1; });
+    damage([&](std::string& b) { b[layout.louds] = 0; });
+    damage([&](std::string& b) {
+        std::size_t last = layout.louds + (layout.louds_words - 1) * 8 + 7;
+        b[last] = static_cast<char>(0x80);
+    });
+    damage([&](std::string& b) { Poke<std::uint32_t>(b, layout.zero_rank + 4, 0); });
+    damage([&](std::string& b) { Poke<std::uint32_t>(b, layout.zero_rank + layout.louds_words * 4, 0xFFFFFFFF); });
+    damage([&](std::string& b) { Poke<std::uint32_t>(b, layout.samples, 0xFFFFFFFF); });
+    damage([&](std::string& b) { Poke<std::uint32_t>(b, layout.samples + 4, 0); });
+    damage([&](std::string& b) { b[layout.terminal] ^= 1; });
+    damage([&](std::string& b) { Poke<std::uint32_t>(b, layout.terminal_rank + 4, 0xFFFFFFF0); });
+    damage([&](std::string& b) { std::swap(b[layout.labels + 1], b[layout.labels + 2]); });
+    for(const std::string& bytes : damaged) {
+        CHECK(!Opens(bad_path, bytes));
+    }
+
+    // Random flips: whatever opens must answer without leaving the mapping
+    // (run under ASan to catch that)
+    int opened = 0;
+    for(int round = 0; round < 3000; ++round) {
+        std::string bytes = good;
+        for(int flips = 1 + rng() % 3; flips > 0; --flips) {
+            std::size_t at = sizeof(SnapshotLayout::Header) + rng() % (bytes.size() - sizeof(SnapshotLayout::Header));
+            bytes[at] = static_cast<char>(bytes[at] ^ (1 << (rng() % 8)));
+        }
+        WriteFile(bad_path, bytes);
+        PrefixTreeSnapshot snapshot;
+        if(snapshot.open(bad_path)) {
+            ++opened;
+            for(int q = 0; q < 20; ++q) {
+                const std::string& word = words[rng() % words.size()];
+                snapshot.find(word);
+                snapshot.prefix_find(word.substr(0, 1 + rng() % word.size()), 10);
+            }
+        }
+    }
+    // Only count and max_count bytes can change without failing validation
+    CHECK(opened > 0);
+    CHECK(opened < 3000);
+    CHECK(Peek<std::uint64_t>(good, 0) == SnapshotLayout::kMagic);
+
+    std::filesystem::remove(good_path);
+    std::filesystem::remove(bad_path);
+    return CheckFailures();
+}